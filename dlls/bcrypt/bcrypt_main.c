@@ -427,6 +427,9 @@ struct hash
     ULONG             secret_len;
     struct hash_impl  outer;
     struct hash_impl  inner;
+    /* state after hash_prepare(), restored when the hash is reused */
+    struct hash_impl  outer_start;
+    struct hash_impl  inner_start;
 };
 
 #define BLOCK_LENGTH_3DES       8
@@ -822,6 +825,13 @@ static NTSTATUS hash_prepare( struct hash *hash )
     return hash_update( &hash->inner, hash->alg_id, buffer, block_bytes );
 }
 
+/* return to the prepared state without hashing the key pads again */
+static void hash_reset( struct hash *hash )
+{
+    hash->inner = hash->inner_start;
+    if (hash->flags & HASH_FLAG_HMAC) hash->outer = hash->outer_start;
+}
+
 static NTSTATUS hash_create( const struct algorithm *alg, UCHAR *secret, ULONG secret_len, ULONG flags,
                              struct hash **ret_hash )
 {
@@ -849,6 +859,8 @@ static NTSTATUS hash_create( const struct algorithm *alg, UCHAR *secret, ULONG s
         free( hash );
         return status;
     }
+    hash->inner_start = hash->inner;
+    hash->outer_start = hash->outer;
 
     *ret_hash = hash;
     return STATUS_SUCCESS;
@@ -943,7 +955,7 @@ static NTSTATUS hash_finalize( struct hash *hash, UCHAR *output, ULONG size )
     if (!(hash->flags & HASH_FLAG_HMAC))
     {
         if ((status = hash_finish( &hash->inner, hash->alg_id, output, size ))) return status;
-        if (hash->flags & HASH_FLAG_REUSABLE) return hash_prepare( hash );
+        if (hash->flags & HASH_FLAG_REUSABLE) hash_reset( hash );
         return STATUS_SUCCESS;
     }
 
@@ -952,7 +964,7 @@ static NTSTATUS hash_finalize( struct hash *hash, UCHAR *output, ULONG size )
     if ((status = hash_update( &hash->outer, hash->alg_id, buffer, hash_length ))) return status;
     if ((status = hash_finish( &hash->outer, hash->alg_id, output, size ))) return status;
 
-    if (hash->flags & HASH_FLAG_REUSABLE) return hash_prepare( hash );
+    if (hash->flags & HASH_FLAG_REUSABLE) hash_reset( hash );
     return STATUS_SUCCESS;
 }
 
@@ -2114,12 +2126,12 @@ NTSTATUS WINAPI BCryptDeriveKeyCapi( BCRYPT_HASH_HANDLE handle, BCRYPT_ALG_HANDL
             pad2[i] = 0x5c ^ (i < len ? buf[i] : 0);
         }
 
-        if ((status = hash_prepare( hash )) ||
-            (status = hash_update( &hash->inner, hash->alg_id, pad1, sizeof(pad1) )) ||
+        hash_reset( hash );
+        if ((status = hash_update( &hash->inner, hash->alg_id, pad1, sizeof(pad1) )) ||
             (status = hash_finalize( hash, buf, len ))) return status;
 
-        if ((status = hash_prepare( hash )) ||
-            (status = hash_update( &hash->inner, hash->alg_id, pad2, sizeof(pad2) )) ||
+        hash_reset( hash );
+        if ((status = hash_update( &hash->inner, hash->alg_id, pad2, sizeof(pad2) )) ||
             (status = hash_finalize( hash, buf + len, len ))) return status;
     }
 
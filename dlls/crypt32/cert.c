@@ -845,6 +845,13 @@ BOOL WINAPI CertSetCertificateContextProperty(PCCERT_CONTEXT pCertContext,
     }
     ret = CertContext_SetProperty(cert_from_ptr(pCertContext), dwPropId, dwFlags,
      pvData);
+    if (ret)
+    {
+        context_t *context;
+
+        for (context = &cert_from_ptr(pCertContext)->base; context; context = context->linked)
+            CRYPT_StoreChanged(context->store);
+    }
     TRACE("returning %d\n", ret);
     return ret;
 }
@@ -34,6 +34,7 @@ WINE_DEFAULT_DEBUG_CHANNEL(crypt);
 WINE_DECLARE_DEBUG_CHANNEL(chain);
 
 #define DEFAULT_CYCLE_MODULUS 7
+#define DEFAULT_MAX_CACHED_CHAINS 64
 
 /* This represents a subset of a certificate chain engine:  it doesn't include
  * the "hOther" store described by MSDN, because I'm not sure how that's used.
@@ -49,8 +50,25 @@ typedef struct _CertificateChainEngine
     DWORD      dwUrlRetrievalTimeout;
     DWORD      MaximumCachedCertificates;
     DWORD      CycleDetectionModulus;
+    CRITICAL_SECTION cs;
+    struct list cached_chains;
+    DWORD      cached_chain_count;
 } CertificateChainEngine;
 
+typedef struct _CERT_CHAIN_PARA_NO_EXTRA_FIELDS {
+    DWORD            cbSize;
+    CERT_USAGE_MATCH RequestedUsage;
+} CERT_CHAIN_PARA_NO_EXTRA_FIELDS;
+
+struct chain_key
+{
+    BYTE  cert_hash[20];
+    LONG  world_version;
+    DWORD flags;
+    DWORD usage_len;
+    BYTE *usage;
+};
+
 static inline void CRYPT_AddStoresToCollection(HCERTSTORE collection,
  DWORD cStores, HCERTSTORE *stores)
 {
@@ -153,6 +171,10 @@ HCERTCHAINENGINE CRYPT_CreateChainEngine(HCERTSTORE root, DWORD system_store, co
         engine->CycleDetectionModulus = config->CycleDetectionModulus;
     else
         engine->CycleDetectionModulus = DEFAULT_CYCLE_MODULUS;
+    InitializeCriticalSection(&engine->cs);
+    engine->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": CertificateChainEngine.cs");
+    list_init(&engine->cached_chains);
+    engine->cached_chain_count = 0;
 
     return engine;
 }
@@ -194,11 +216,193 @@ static CertificateChainEngine *get_chain_engine(HCERTCHAINENGINE handle, BOOL al
     return (CertificateChainEngine*)handle;
 }
 
+/* A chain built for a certificate, reused while the engine's stores are
+ * unchanged and all of its certificates remain time valid. */
+struct cached_chain
+{
+    struct list          entry;
+    struct chain_key     key;
+    FILETIME             not_before;
+    FILETIME             not_after;
+    PCCERT_CHAIN_CONTEXT chain;
+};
+
+static void CRYPT_FreeCachedChain(struct cached_chain *cached)
+{
+    CertFreeCertificateChain(cached->chain);
+    CryptMemFree(cached->key.usage);
+    CryptMemFree(cached);
+}
+
+static void CRYPT_FreeChainKey(struct chain_key *key)
+{
+    CryptMemFree(key->usage);
+    key->usage = NULL;
+}
+
+/* Identifies the chain requested for cert: the certificate, the version of the
+ * engine's stores, the flags and the requested usage. */
+static BOOL CRYPT_GetChainKey(CertificateChainEngine *engine, PCCERT_CONTEXT cert,
+ const CERT_CHAIN_PARA *pChainPara, DWORD flags, struct chain_key *key)
+{
+    DWORD size = sizeof(key->cert_hash);
+
+    memset(key, 0, sizeof(*key));
+    key->flags = flags;
+    /* hWorld contains hRoot, as well as the CA, My and Trust stores */
+    if (engine->hWorld)
+        key->world_version = CRYPT_GetStoreVersion(engine->hWorld);
+    if (!CertGetCertificateContextProperty(cert, CERT_HASH_PROP_ID,
+     key->cert_hash, &size))
+        return FALSE;
+
+    if (pChainPara->cbSize >= sizeof(CERT_CHAIN_PARA_NO_EXTRA_FIELDS) &&
+     pChainPara->RequestedUsage.Usage.cUsageIdentifier)
+    {
+        const CERT_USAGE_MATCH *usage = &pChainPara->RequestedUsage;
+        DWORD i;
+        BYTE *ptr;
+
+        key->usage_len = sizeof(usage->dwType);
+        for (i = 0; i < usage->Usage.cUsageIdentifier; i++)
+            key->usage_len += strlen(usage->Usage.rgpszUsageIdentifier[i]) + 1;
+        if (!(key->usage = CryptMemAlloc(key->usage_len)))
+            return FALSE;
+        memcpy(key->usage, &usage->dwType, sizeof(usage->dwType));
+        ptr = key->usage + sizeof(usage->dwType);
+        for (i = 0; i < usage->Usage.cUsageIdentifier; i++)
+        {
+            size = strlen(usage->Usage.rgpszUsageIdentifier[i]) + 1;
+            memcpy(ptr, usage->Usage.rgpszUsageIdentifier[i], size);
+            ptr += size;
+        }
+    }
+    return TRUE;
+}
+
+static BOOL CRYPT_HasExtraChainParams(const CERT_CHAIN_PARA *pChainPara)
+{
+    if (pChainPara->cbSize < sizeof(CERT_CHAIN_PARA))
+        return FALSE;
+    return pChainPara->RequestedIssuancePolicy.Usage.cUsageIdentifier ||
+     pChainPara->dwUrlRetrievalTimeout || pChainPara->fCheckRevocationFreshnessTime ||
+     pChainPara->dwRevocationFreshnessTime || pChainPara->pftCacheResync;
+}
+
+static BOOL CRYPT_ChainKeysEqual(const struct chain_key *a, const struct chain_key *b)
+{
+    return a->world_version == b->world_version &&
+     a->flags == b->flags && a->usage_len == b->usage_len &&
+     !memcmp(a->cert_hash, b->cert_hash, sizeof(a->cert_hash)) &&
+     (!a->usage_len || !memcmp(a->usage, b->usage, a->usage_len));
+}
+
+static PCCERT_CHAIN_CONTEXT CRYPT_FindCachedChain(CertificateChainEngine *engine,
+ const struct chain_key *key)
+{
+    struct cached_chain *cached, *next;
+    PCCERT_CHAIN_CONTEXT ret = NULL;
+    FILETIME now;
+
+    GetSystemTimeAsFileTime(&now);
+
+    EnterCriticalSection(&engine->cs);
+    LIST_FOR_EACH_ENTRY_SAFE(cached, next, &engine->cached_chains, struct cached_chain, entry)
+    {
+        if (cached->key.world_version != key->world_version ||
+         CompareFileTime(&now, &cached->not_before) < 0 ||
+         CompareFileTime(&now, &cached->not_after) > 0)
+        {
+            list_remove(&cached->entry);
+            engine->cached_chain_count--;
+            CRYPT_FreeCachedChain(cached);
+            continue;
+        }
+        if (CRYPT_ChainKeysEqual(&cached->key, key))
+        {
+            list_remove(&cached->entry);
+            list_add_head(&engine->cached_chains, &cached->entry);
+            ret = CertDuplicateCertificateChain(cached->chain);
+            break;
+        }
+    }
+    LeaveCriticalSection(&engine->cs);
+
+    TRACE_(chain)("cached chain %p\n", ret);
+    return ret;
+}
+
+/* Takes ownership of the key's usage if the chain is cached. */
+static void CRYPT_CacheChain(CertificateChainEngine *engine, struct chain_key *key,
+ PCCERT_CHAIN_CONTEXT chain)
+{
+    struct cached_chain *cached;
+    DWORD i, j, max_count;
+    FILETIME now;
+
+    if (chain->TrustStatus.dwErrorStatus & CERT_TRUST_IS_PARTIAL_CHAIN)
+    {
+        /* A missing issuer may be added or retrieved later */
+        return;
+    }
+    if (!(cached = CryptMemAlloc(sizeof(*cached))))
+        return;
+    cached->key = *key;
+    key->usage = NULL;
+    cached->chain = CertDuplicateCertificateChain(chain);
+    cached->not_before = chain->rgpChain[0]->rgpElement[0]->pCertContext->pCertInfo->NotBefore;
+    cached->not_after = chain->rgpChain[0]->rgpElement[0]->pCertContext->pCertInfo->NotAfter;
+    for (i = 0; i < chain->cChain; i++)
+    {
+        for (j = 0; j < chain->rgpChain[i]->cElement; j++)
+        {
+            const CERT_INFO *info = chain->rgpChain[i]->rgpElement[j]->pCertContext->pCertInfo;
+
+            if (CompareFileTime(&info->NotBefore, &cached->not_before) > 0)
+                cached->not_before = info->NotBefore;
+            if (CompareFileTime(&info->NotAfter, &cached->not_after) < 0)
+                cached->not_after = info->NotAfter;
+        }
+    }
+
+    GetSystemTimeAsFileTime(&now);
+    if (CompareFileTime(&now, &cached->not_before) < 0 ||
+     CompareFileTime(&now, &cached->not_after) > 0)
+    {
+        CRYPT_FreeCachedChain(cached);
+        return;
+    }
+
+    max_count = engine->MaximumCachedCertificates ? engine->MaximumCachedCertificates
+     : DEFAULT_MAX_CACHED_CHAINS;
+
+    EnterCriticalSection(&engine->cs);
+    list_add_head(&engine->cached_chains, &cached->entry);
+    engine->cached_chain_count++;
+    while (engine->cached_chain_count > max_count)
+    {
+        cached = LIST_ENTRY(list_tail(&engine->cached_chains), struct cached_chain, entry);
+        list_remove(&cached->entry);
+        engine->cached_chain_count--;
+        CRYPT_FreeCachedChain(cached);
+    }
+    LeaveCriticalSection(&engine->cs);
+}
+
 static void free_chain_engine(CertificateChainEngine *engine)
 {
+    struct cached_chain *cached, *next;
+
     if(!engine || InterlockedDecrement(&engine->ref))
         return;
 
+    LIST_FOR_EACH_ENTRY_SAFE(cached, next, &engine->cached_chains, struct cached_chain, entry)
+    {
+        list_remove(&cached->entry);
+        CRYPT_FreeCachedChain(cached);
+    }
+    engine->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection(&engine->cs);
     CertCloseStore(engine->hWorld, 0);
     CertCloseStore(engine->hRoot, 0);
     CryptMemFree(engine);
@@ -2620,11 +2824,6 @@ static PCERT_CHAIN_ELEMENT CRYPT_FindIthElementInChain(
     return element;
 }
 
-typedef struct _CERT_CHAIN_PARA_NO_EXTRA_FIELDS {
-    DWORD            cbSize;
-    CERT_USAGE_MATCH RequestedUsage;
-} CERT_CHAIN_PARA_NO_EXTRA_FIELDS;
-
 static void CRYPT_VerifyChainRevocation(PCERT_CHAIN_CONTEXT chain,
  LPFILETIME pTime, HCERTSTORE hAdditionalStore,
  const CERT_CHAIN_PARA *pChainPara, DWORD chainFlags)
@@ -2878,8 +3077,9 @@ BOOL WINAPI CertGetCertificateChain(HCERTCHAINENGINE hChainEngine,
  PCCERT_CHAIN_CONTEXT* ppChainContext)
 {
     CertificateChainEngine *engine;
-    BOOL ret;
+    BOOL ret, use_cache;
     CertificateChain *chain = NULL;
+    struct chain_key key;
 
     TRACE("(%p, %p, %s, %p, %p, %08lx, %p, %p)\n", hChainEngine, pCertContext,
      debugstr_filetime(pTime), hAdditionalStore, pChainPara, dwFlags,
@@ -2904,6 +3104,33 @@ BOOL WINAPI CertGetCertificateChain(HCERTCHAINENGINE hChainEngine,
 
     if (TRACE_ON(chain))
         dump_chain_para(pChainPara);
+
+    /* Chains checked at a given time or for revocation aren't cached, the
+     * result of the latter may change without any store being modified.
+     * Neither are chains built with an additional store, they hold a
+     * reference to it, and neither are chains requested with parameters
+     * that aren't part of the key. */
+    use_cache = !pTime && !pvReserved && !hAdditionalStore &&
+     !(dwFlags & (CERT_CHAIN_REVOCATION_CHECK_END_CERT | CERT_CHAIN_REVOCATION_CHECK_CHAIN |
+     CERT_CHAIN_REVOCATION_CHECK_CHAIN_EXCLUDE_ROOT)) &&
+     !CRYPT_HasExtraChainParams(pChainPara) &&
+     CRYPT_GetChainKey(engine, pCertContext, pChainPara, dwFlags, &key);
+    if (use_cache)
+    {
+        PCCERT_CHAIN_CONTEXT cached;
+
+        if ((cached = CRYPT_FindCachedChain(engine, &key)))
+        {
+            CRYPT_FreeChainKey(&key);
+            if (ppChainContext)
+                *ppChainContext = cached;
+            else
+                CertFreeCertificateChain(cached);
+            TRACE("returning cached chain\n");
+            return TRUE;
+        }
+    }
+
     /* FIXME: what about HCCE_LOCAL_MACHINE? */
     ret = CRYPT_BuildCandidateChainFromCert(engine, pCertContext, pTime,
      hAdditionalStore, dwFlags, &chain);
@@ -2932,11 +3159,15 @@ BOOL WINAPI CertGetCertificateChain(HCERTCHAINENGINE hChainEngine,
         CRYPT_CheckUsages(pChain, pChainPara);
         TRACE_(chain)("error status: %08lx\n",
          pChain->TrustStatus.dwErrorStatus);
+        if (use_cache)
+            CRYPT_CacheChain(engine, &key, pChain);
         if (ppChainContext)
             *ppChainContext = pChain;
         else
             CertFreeCertificateChain(pChain);
     }
+    if (use_cache)
+        CRYPT_FreeChainKey(&key);
     TRACE("returning %d\n", ret);
     return ret;
 }
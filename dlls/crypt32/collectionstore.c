@@ -486,6 +486,23 @@ WINECRYPT_CERTSTORE *CRYPT_CollectionOpenStore(HCRYPTPROV hCryptProv,
     return (WINECRYPT_CERTSTORE*)store;
 }
 
+LONG CRYPT_CollectionGetVersion(WINECRYPT_CERTSTORE *store)
+{
+    WINE_COLLECTIONSTORE *cs = (WINE_COLLECTIONSTORE*)store;
+    WINE_STORE_LIST_ENTRY *entry;
+    LONG version, ret = store->version;
+
+    EnterCriticalSection(&cs->cs);
+    LIST_FOR_EACH_ENTRY(entry, &cs->stores, WINE_STORE_LIST_ENTRY, entry)
+    {
+        version = CRYPT_GetStoreVersion(entry->store);
+        if (version > ret)
+            ret = version;
+    }
+    LeaveCriticalSection(&cs->cs);
+    return ret;
+}
+
 BOOL WINAPI CertAddStoreToCollection(HCERTSTORE hCollectionStore,
  HCERTSTORE hSiblingStore, DWORD dwUpdateFlags, DWORD dwPriority)
 {
@@ -545,6 +562,7 @@ BOOL WINAPI CertAddStoreToCollection(HCERTSTORE hCollectionStore,
         }
         else
             list_add_tail(&collection->stores, &entry->entry);
+        CRYPT_StoreChanged(&collection->hdr);
         LeaveCriticalSection(&collection->cs);
         ret = TRUE;
     }
@@ -584,6 +602,7 @@ void WINAPI CertRemoveStoreFromCollection(HCERTSTORE hCollectionStore,
             list_remove(&store->entry);
             CertCloseStore(store->store, 0);
             CryptMemFree(store);
+            CRYPT_StoreChanged(&collection->hdr);
             break;
         }
     }
@@ -322,11 +322,19 @@ typedef struct WINE_CRYPTCERTSTORE
     CertStoreType               type;
     const store_vtbl_t         *vtbl;
     CONTEXT_PROPERTY_LIST      *properties;
+    LONG                        version;
 } WINECRYPT_CERTSTORE;
 
 void CRYPT_InitStore(WINECRYPT_CERTSTORE *store, DWORD dwFlags,
  CertStoreType type, const store_vtbl_t*) DECLSPEC_HIDDEN;
 void CRYPT_FreeStore(WINECRYPT_CERTSTORE *store) DECLSPEC_HIDDEN;
+
+/* A store's version changes whenever its contents, the contents of any store
+ * it contains, or the properties of its certificates change. */
+void CRYPT_StoreChanged(WINECRYPT_CERTSTORE *store) DECLSPEC_HIDDEN;
+LONG CRYPT_GetStoreVersion(WINECRYPT_CERTSTORE *store) DECLSPEC_HIDDEN;
+LONG CRYPT_CollectionGetVersion(WINECRYPT_CERTSTORE *store) DECLSPEC_HIDDEN;
+LONG CRYPT_ProvGetVersion(WINECRYPT_CERTSTORE *store) DECLSPEC_HIDDEN;
 BOOL WINAPI I_CertUpdateStore(HCERTSTORE store1, HCERTSTORE store2, DWORD unk0,
  DWORD unk1) DECLSPEC_HIDDEN;
 
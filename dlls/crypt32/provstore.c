@@ -304,6 +304,21 @@ static const store_vtbl_t ProvStoreVtbl = {
     }
 };
 
+LONG CRYPT_ProvGetVersion(WINECRYPT_CERTSTORE *store)
+{
+    WINE_PROVIDERSTORE *ps = (WINE_PROVIDERSTORE*)store;
+    LONG version;
+
+    /* Changes to an external provider's contents can't be tracked */
+    if (!ps->memStore)
+    {
+        CRYPT_StoreChanged(store);
+        return store->version;
+    }
+    version = CRYPT_GetStoreVersion(ps->memStore);
+    return version > store->version ? version : store->version;
+}
+
 WINECRYPT_CERTSTORE *CRYPT_ProvCreateStore(DWORD dwFlags,
  WINECRYPT_CERTSTORE *memStore, const CERT_STORE_PROV_INFO *pProvInfo)
 {
@@ -76,6 +76,10 @@ static const WINE_CONTEXT_INTERFACE gCTLInterface = {
 };
 const WINE_CONTEXT_INTERFACE *pCTLInterface = &gCTLInterface;
 
+/* Store versions are taken from a single counter, so that the highest version
+ * of a collection's children always grows when any of them changes. */
+static LONG store_version_counter;
+
 typedef struct _WINE_MEMSTORE
 {
     WINECRYPT_CERTSTORE hdr;
@@ -93,6 +97,25 @@ void CRYPT_InitStore(WINECRYPT_CERTSTORE *store, DWORD dwFlags, CertStoreType ty
     store->dwOpenFlags = dwFlags;
     store->vtbl = vtbl;
     store->properties = NULL;
+    store->version = 0;
+}
+
+void CRYPT_StoreChanged(WINECRYPT_CERTSTORE *store)
+{
+    store->version = InterlockedIncrement(&store_version_counter);
+}
+
+LONG CRYPT_GetStoreVersion(WINECRYPT_CERTSTORE *store)
+{
+    switch (store->type)
+    {
+    case StoreTypeCollection:
+        return CRYPT_CollectionGetVersion(store);
+    case StoreTypeProvider:
+        return CRYPT_ProvGetVersion(store);
+    default:
+        return store->version;
+    }
 }
 
 void CRYPT_FreeStore(WINECRYPT_CERTSTORE *store)
@@ -162,6 +185,7 @@ static BOOL MemStore_addContext(WINE_MEMSTORE *store, struct list *list, context
     }else {
         list_add_head(list, &context->u.entry);
     }
+    CRYPT_StoreChanged(&store->hdr);
     LeaveCriticalSection(&store->cs);
 
     if(ret_context)
@@ -204,6 +228,7 @@ static BOOL MemStore_deleteContext(WINE_MEMSTORE *store, context_t *context)
         list_remove(&context->u.entry);
         list_init(&context->u.entry);
         in_list = TRUE;
+        CRYPT_StoreChanged(&store->hdr);
     }
     LeaveCriticalSection(&store->cs);
 
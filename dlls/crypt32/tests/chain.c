@@ -5379,10 +5379,87 @@ static void testVerifyCertChainPolicy(void)
     check_msroot_policy();
 }
 
+static void test_chain_cache(void)
+{
+    PCCERT_CHAIN_CONTEXT chain, chain2;
+    CERT_CHAIN_ENGINE_CONFIG config = { sizeof(config) };
+    CERT_CHAIN_PARA para = { sizeof(para) };
+    HCERTCHAINENGINE engine;
+    HCERTSTORE root, additional;
+    CERT_NAME_BLOB name;
+    PCCERT_CONTEXT cert;
+    BYTE encoded[64];
+    DWORD size;
+    BOOL ret;
+
+    size = sizeof(encoded);
+    ret = CertStrToNameW(X509_ASN_ENCODING, L"CN=chain cache test", CERT_X500_NAME_STR, NULL,
+     encoded, &size, NULL);
+    ok(ret, "CertStrToNameW failed: %08lx\n", GetLastError());
+    name.pbData = encoded;
+    name.cbData = size;
+    cert = CertCreateSelfSignCertificate(0, &name, 0, NULL, NULL, NULL, NULL, NULL);
+    if (!cert)
+    {
+        skip("CertCreateSelfSignCertificate failed: %08lx\n", GetLastError());
+        return;
+    }
+
+    root = CertOpenStore(CERT_STORE_PROV_MEMORY, 0, 0, CERT_STORE_CREATE_NEW_FLAG, NULL);
+    additional = CertOpenStore(CERT_STORE_PROV_MEMORY, 0, 0, CERT_STORE_CREATE_NEW_FLAG, NULL);
+    config.hExclusiveRoot = root;
+    ret = CertCreateCertificateChainEngine(&config, &engine);
+    ok(ret, "CertCreateCertificateChainEngine failed: %08lx\n", GetLastError());
+
+    ret = CertGetCertificateChain(engine, cert, NULL, NULL, &para, 0, NULL, &chain);
+    ok(ret, "CertGetCertificateChain failed: %08lx\n", GetLastError());
+    ok(chain->TrustStatus.dwErrorStatus & CERT_TRUST_IS_UNTRUSTED_ROOT,
+     "got error status %08lx\n", chain->TrustStatus.dwErrorStatus);
+
+    /* Nothing changed, the same chain is returned */
+    ret = CertGetCertificateChain(engine, cert, NULL, NULL, &para, 0, NULL, &chain2);
+    ok(ret, "CertGetCertificateChain failed: %08lx\n", GetLastError());
+    ok(chain2 == chain || broken(chain2 != chain) /* native doesn't cache by default */,
+     "expected the cached chain\n");
+    CertFreeCertificateChain(chain2);
+
+    /* A short chain para is accepted */
+    para.cbSize = 0;
+    ret = CertGetCertificateChain(engine, cert, NULL, NULL, &para, 0, NULL, &chain2);
+    ok(ret, "CertGetCertificateChain failed: %08lx\n", GetLastError());
+    ok(chain2->TrustStatus.dwErrorStatus & CERT_TRUST_IS_UNTRUSTED_ROOT,
+     "got error status %08lx\n", chain2->TrustStatus.dwErrorStatus);
+    CertFreeCertificateChain(chain2);
+    para.cbSize = sizeof(para);
+
+    /* Chains built with an additional store aren't cached */
+    ret = CertGetCertificateChain(engine, cert, NULL, additional, &para, 0, NULL, &chain2);
+    ok(ret, "CertGetCertificateChain failed: %08lx\n", GetLastError());
+    ok(chain2 != chain, "got the cached chain\n");
+    CertFreeCertificateChain(chain2);
+
+    /* Trusting the certificate invalidates the chain */
+    ret = CertAddCertificateContextToStore(root, cert, CERT_STORE_ADD_ALWAYS, NULL);
+    ok(ret, "CertAddCertificateContextToStore failed: %08lx\n", GetLastError());
+    ret = CertGetCertificateChain(engine, cert, NULL, NULL, &para, 0, NULL, &chain2);
+    ok(ret, "CertGetCertificateChain failed: %08lx\n", GetLastError());
+    ok(chain2 != chain, "got the stale chain\n");
+    ok(!(chain2->TrustStatus.dwErrorStatus & CERT_TRUST_IS_UNTRUSTED_ROOT),
+     "got error status %08lx\n", chain2->TrustStatus.dwErrorStatus);
+    CertFreeCertificateChain(chain2);
+    CertFreeCertificateChain(chain);
+
+    CertFreeCertificateChainEngine(engine);
+    CertCloseStore(additional, 0);
+    CertCloseStore(root, 0);
+    CertFreeCertificateContext(cert);
+}
+
 START_TEST(chain)
 {
     testCreateCertChainEngine();
     testVerifyCertChainPolicy();
     testGetCertChain();
     test_CERT_CHAIN_PARA_cbSize();
+    test_chain_cache();
 }
@@ -1634,6 +1634,438 @@ static HRESULT remap_faces_for_attrsort(struct d3dx9_mesh *This, const DWORD *in
     return D3D_OK;
 }
 
+/* Reorders vertices in the order they are first referenced by the faces,
+ * which are visited in the order given by face_remap (old -> new). Vertices
+ * not referenced by any face are removed if compact is set, otherwise they
+ * are appended at the end. Indices are updated according to the vertex_remap. */
+static HRESULT reorder_vertices(struct d3dx9_mesh *This, DWORD *indices, const DWORD *face_remap,
+        BOOL compact, DWORD *new_num_vertices, ID3DXBuffer **vertex_remap)
+{
+    DWORD *vertex_remap_ptr;
+    DWORD *face_order;
+    DWORD *vertex_map;
+    DWORD num_vertices = 0;
+    DWORD i, j;
+    HRESULT hr;
+
+    if (!(face_order = HeapAlloc(GetProcessHeap(), 0, This->numfaces * sizeof(*face_order))))
+        return E_OUTOFMEMORY;
+    if (!(vertex_map = HeapAlloc(GetProcessHeap(), 0, This->numvertices * sizeof(*vertex_map))))
+    {
+        HeapFree(GetProcessHeap(), 0, face_order);
+        return E_OUTOFMEMORY;
+    }
+    if (FAILED(hr = D3DXCreateBuffer(This->numvertices * sizeof(DWORD), vertex_remap)))
+    {
+        HeapFree(GetProcessHeap(), 0, vertex_map);
+        HeapFree(GetProcessHeap(), 0, face_order);
+        return hr;
+    }
+    vertex_remap_ptr = ID3DXBuffer_GetBufferPointer(*vertex_remap);
+
+    for (i = 0; i < This->numfaces; i++)
+        face_order[face_remap[i]] = i;
+    memset(vertex_map, 0xff, This->numvertices * sizeof(*vertex_map));
+
+    /* create old->new and new->old vertex mappings */
+    for (i = 0; i < This->numfaces; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            DWORD vertex_index = indices[face_order[i] * 3 + j];
+
+            if (vertex_index >= This->numvertices)
+            {
+                WARN("Face %u references invalid vertex %u.\n", face_order[i], vertex_index);
+                hr = D3DERR_INVALIDCALL;
+                goto done;
+            }
+            if (vertex_map[vertex_index] == -1)
+            {
+                vertex_map[vertex_index] = num_vertices;
+                vertex_remap_ptr[num_vertices++] = vertex_index;
+            }
+        }
+    }
+    if (!compact)
+    {
+        for (i = 0; i < This->numvertices; i++)
+        {
+            if (vertex_map[i] == -1)
+            {
+                vertex_map[i] = num_vertices;
+                vertex_remap_ptr[num_vertices++] = i;
+            }
+        }
+    }
+    for (i = num_vertices; i < This->numvertices; i++)
+        vertex_remap_ptr[i] = -1;
+
+    /* convert indices */
+    for (i = 0; i < This->numfaces * 3; i++)
+        indices[i] = vertex_map[indices[i]];
+
+    *new_num_vertices = num_vertices;
+
+done:
+    if (FAILED(hr))
+    {
+        ID3DXBuffer_Release(*vertex_remap);
+        *vertex_remap = NULL;
+    }
+    HeapFree(GetProcessHeap(), 0, vertex_map);
+    HeapFree(GetProcessHeap(), 0, face_order);
+    return hr;
+}
+
+/* Size of the simulated post-transform vertex cache. The default is used with
+ * D3DXMESHOPT_DEVICEINDEPENDENT or when the device doesn't report its cache. */
+#define D3DX_VCACHE_DEFAULT_SIZE 16
+#define D3DX_VCACHE_MAX_SIZE 32
+
+struct vcache_vertex
+{
+    float score;
+    int cache_pos;
+    /* Number of faces using this vertex which haven't been emitted yet; they
+     * are stored first in the vertex's slice of the face list. */
+    DWORD active_count;
+    DWORD face_start;
+};
+
+static unsigned int get_vertex_cache_size(struct d3dx9_mesh *mesh, DWORD flags)
+{
+    IDirect3DQuery9 *query;
+    D3DDEVINFO_VCACHE vcache;
+    unsigned int size = D3DX_VCACHE_DEFAULT_SIZE;
+
+    if (flags & D3DXMESHOPT_DEVICEINDEPENDENT)
+        return size;
+
+    if (FAILED(IDirect3DDevice9_CreateQuery(mesh->device, D3DQUERYTYPE_VCACHE, &query)))
+        return size;
+
+    if (SUCCEEDED(IDirect3DQuery9_Issue(query, D3DISSUE_END))
+            && IDirect3DQuery9_GetData(query, &vcache, sizeof(vcache), D3DGETDATA_FLUSH) == S_OK
+            && vcache.OptMethod == 1 && vcache.CacheSize)
+        size = min(max(vcache.CacheSize, 4), D3DX_VCACHE_MAX_SIZE);
+    IDirect3DQuery9_Release(query);
+
+    TRACE("Using vertex cache size %u.\n", size);
+    return size;
+}
+
+/* Vertex scoring from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation":
+ * vertices in the cache score higher the more recently they were used, and
+ * vertices with few remaining faces get a boost so that isolated faces aren't
+ * left behind. */
+static float vcache_vertex_score(const struct vcache_vertex *vertex, unsigned int cache_size)
+{
+    float score = 0.0f;
+
+    if (!vertex->active_count)
+        return -1.0f;
+
+    if (vertex->cache_pos >= 0)
+    {
+        /* The vertices of the last face are fixed, whichever order they're
+         * emitted in. */
+        if (vertex->cache_pos < 3)
+            score = 0.75f;
+        else
+            score = powf(1.0f - (vertex->cache_pos - 3) / (float)(cache_size - 3), 1.5f);
+    }
+
+    return score + 2.0f / sqrtf(vertex->active_count);
+}
+
+/* Computes a vertex cache friendly face order for each attribute range of an
+ * attribute-sorted mesh. face_order receives the new -> old face mapping. */
+static HRESULT optimize_faces_vcache(const DWORD *indices, DWORD num_faces, DWORD num_vertices,
+        const DWORD *attribs, unsigned int cache_size, DWORD *face_order)
+{
+    DWORD cache[D3DX_VCACHE_MAX_SIZE + 3], new_cache[D3DX_VCACHE_MAX_SIZE + 3];
+    DWORD cache_count = 0, new_cache_count;
+    struct vcache_vertex *vertices;
+    DWORD start, end, cursor, out;
+    DWORD *face_list;
+    BYTE *emitted;
+    DWORD i, j, k;
+
+    vertices = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, num_vertices * sizeof(*vertices));
+    face_list = HeapAlloc(GetProcessHeap(), 0, num_faces * 3 * sizeof(*face_list));
+    emitted = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, num_faces * sizeof(*emitted));
+    if (!vertices || !face_list || !emitted)
+    {
+        HeapFree(GetProcessHeap(), 0, vertices);
+        HeapFree(GetProcessHeap(), 0, face_list);
+        HeapFree(GetProcessHeap(), 0, emitted);
+        return E_OUTOFMEMORY;
+    }
+
+    /* build the vertex -> face lists */
+    for (i = 0; i < num_faces * 3; i++)
+    {
+        if (indices[i] >= num_vertices)
+        {
+            WARN("Face %u references invalid vertex %u.\n", i / 3, indices[i]);
+            HeapFree(GetProcessHeap(), 0, vertices);
+            HeapFree(GetProcessHeap(), 0, face_list);
+            HeapFree(GetProcessHeap(), 0, emitted);
+            return D3DERR_INVALIDCALL;
+        }
+        vertices[indices[i]].face_start++;
+    }
+    for (i = 0, j = 0; i < num_vertices; i++)
+    {
+        DWORD count = vertices[i].face_start;
+
+        vertices[i].face_start = j;
+        vertices[i].cache_pos = -1;
+        j += count;
+    }
+    for (i = 0; i < num_faces * 3; i++)
+    {
+        struct vcache_vertex *vertex = &vertices[indices[i]];
+        face_list[vertex->face_start + vertex->active_count++] = i / 3;
+    }
+    for (i = 0; i < num_vertices; i++)
+        vertices[i].score = vcache_vertex_score(&vertices[i], cache_size);
+
+    out = 0;
+    for (start = 0; start < num_faces; start = end)
+    {
+        DWORD best_face = -1;
+
+        for (end = start + 1; end < num_faces && attribs[end] == attribs[start]; end++)
+            ;
+
+        /* Each attribute range is drawn separately, start with a cold cache. */
+        for (i = 0; i < cache_count; i++)
+        {
+            vertices[cache[i]].cache_pos = -1;
+            vertices[cache[i]].score = vcache_vertex_score(&vertices[cache[i]], cache_size);
+        }
+        cache_count = 0;
+
+        for (cursor = start; out < end;)
+        {
+            const DWORD *face_indices;
+            float best_score;
+
+            if (best_face == -1)
+            {
+                /* Nothing left in the cache, restart from the next face in
+                 * input order. */
+                while (emitted[cursor])
+                    cursor++;
+                best_face = cursor;
+            }
+
+            face_order[out++] = best_face;
+            emitted[best_face] = 1;
+            face_indices = &indices[best_face * 3];
+
+            /* remove the face from the active lists of its vertices */
+            for (j = 0; j < 3; j++)
+            {
+                struct vcache_vertex *vertex = &vertices[face_indices[j]];
+                DWORD *list = &face_list[vertex->face_start];
+
+                for (k = 0; k < vertex->active_count; k++)
+                {
+                    if (list[k] == best_face)
+                    {
+                        list[k] = list[--vertex->active_count];
+                        list[vertex->active_count] = best_face;
+                        break;
+                    }
+                }
+            }
+
+            /* move the face's vertices to the front of the cache */
+            new_cache_count = 0;
+            for (j = 0; j < 3; j++)
+            {
+                for (k = 0; k < new_cache_count; k++)
+                    if (new_cache[k] == face_indices[j]) break;
+                if (k == new_cache_count)
+                    new_cache[new_cache_count++] = face_indices[j];
+            }
+            for (j = 0; j < cache_count; j++)
+            {
+                if (cache[j] != face_indices[0] && cache[j] != face_indices[1] && cache[j] != face_indices[2])
+                    new_cache[new_cache_count++] = cache[j];
+            }
+
+            /* update the scores of the vertices which are or were in the
+             * cache and pick the best face using them */
+            for (j = 0; j < new_cache_count; j++)
+            {
+                struct vcache_vertex *vertex = &vertices[new_cache[j]];
+
+                vertex->cache_pos = j < cache_size ? j : -1;
+                vertex->score = vcache_vertex_score(vertex, cache_size);
+            }
+            best_face = -1;
+            best_score = -1.0f;
+            for (j = 0; j < new_cache_count; j++)
+            {
+                const struct vcache_vertex *vertex = &vertices[new_cache[j]];
+                const DWORD *list = &face_list[vertex->face_start];
+
+                for (k = 0; k < vertex->active_count; k++)
+                {
+                    DWORD face = list[k];
+                    float score;
+
+                    if (face < start || face >= end)
+                        continue;
+                    score = vertices[indices[face * 3]].score + vertices[indices[face * 3 + 1]].score
+                            + vertices[indices[face * 3 + 2]].score;
+                    if (score > best_score)
+                    {
+                        best_score = score;
+                        best_face = face;
+                    }
+                }
+            }
+
+            cache_count = min(new_cache_count, cache_size);
+            memcpy(cache, new_cache, cache_count * sizeof(*cache));
+        }
+    }
+
+    HeapFree(GetProcessHeap(), 0, vertices);
+    HeapFree(GetProcessHeap(), 0, face_list);
+    HeapFree(GetProcessHeap(), 0, emitted);
+    return D3D_OK;
+}
+
+static DWORD count_free_neighbors(const DWORD *adjacency, DWORD face, DWORD start, DWORD end, const BYTE *emitted)
+{
+    DWORD count = 0, i;
+
+    for (i = 0; i < 3; i++)
+    {
+        DWORD neighbor = adjacency[face * 3 + i];
+
+        if (neighbor >= start && neighbor < end && !emitted[neighbor])
+            count++;
+    }
+    return count;
+}
+
+/* Computes a face order which maximizes the length of strips of adjacent faces
+ * for each attribute range of an attribute-sorted mesh, walking towards the
+ * neighbor with the fewest free neighbors as in the classic SGI stripifier.
+ * face_order receives the new -> old face mapping. */
+static HRESULT optimize_faces_strips(const DWORD *adjacency, DWORD num_faces, const DWORD *attribs,
+        DWORD *face_order)
+{
+    DWORD start, end, cursor, out = 0;
+    BYTE *emitted;
+    DWORD i;
+
+    if (!(emitted = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, num_faces * sizeof(*emitted))))
+        return E_OUTOFMEMORY;
+
+    for (start = 0; start < num_faces; start = end)
+    {
+        for (end = start + 1; end < num_faces && attribs[end] == attribs[start]; end++)
+            ;
+
+        for (cursor = start; out < end;)
+        {
+            DWORD face;
+
+            while (emitted[cursor])
+                cursor++;
+
+            for (face = cursor; face != -1;)
+            {
+                DWORD next_face = -1, best_count = 4;
+
+                face_order[out++] = face;
+                emitted[face] = 1;
+
+                for (i = 0; i < 3; i++)
+                {
+                    DWORD neighbor = adjacency[face * 3 + i];
+                    DWORD count;
+
+                    if (neighbor < start || neighbor >= end || emitted[neighbor])
+                        continue;
+                    count = count_free_neighbors(adjacency, neighbor, start, end, emitted);
+                    if (count < best_count)
+                    {
+                        best_count = count;
+                        next_face = neighbor;
+                    }
+                }
+                face = next_face;
+            }
+        }
+    }
+
+    HeapFree(GetProcessHeap(), 0, emitted);
+    return D3D_OK;
+}
+
+/* Reorders the faces within each attribute range for D3DXMESHOPT_VERTEXCACHE
+ * or D3DXMESHOPT_STRIPREORDER. face_remap (old -> new) must come from the
+ * attribute sort and is updated in place. */
+static HRESULT remap_faces_for_cache(struct d3dx9_mesh *This, DWORD flags, const DWORD *indices,
+        const DWORD *adjacency, const DWORD *sorted_attrib_buffer, DWORD *face_remap)
+{
+    DWORD *face_order, *sorted_data;
+    DWORD i, j;
+    HRESULT hr;
+
+    if (!(face_order = HeapAlloc(GetProcessHeap(), 0, This->numfaces * sizeof(*face_order))))
+        return E_OUTOFMEMORY;
+    if (!(sorted_data = HeapAlloc(GetProcessHeap(), 0, This->numfaces * 3 * sizeof(*sorted_data))))
+    {
+        HeapFree(GetProcessHeap(), 0, face_order);
+        return E_OUTOFMEMORY;
+    }
+
+    if (flags & D3DXMESHOPT_VERTEXCACHE)
+    {
+        for (i = 0; i < This->numfaces; i++)
+            memcpy(&sorted_data[face_remap[i] * 3], &indices[i * 3], 3 * sizeof(*indices));
+
+        hr = optimize_faces_vcache(sorted_data, This->numfaces, This->numvertices, sorted_attrib_buffer,
+                get_vertex_cache_size(This, flags), face_order);
+    }
+    else
+    {
+        for (i = 0; i < This->numfaces; i++)
+        {
+            for (j = 0; j < 3; j++)
+            {
+                DWORD neighbor = adjacency[i * 3 + j];
+                sorted_data[face_remap[i] * 3 + j] = neighbor < This->numfaces ? face_remap[neighbor] : -1;
+            }
+        }
+
+        hr = optimize_faces_strips(sorted_data, This->numfaces, sorted_attrib_buffer, face_order);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        /* sorted_data is reused as the sorted -> new face mapping */
+        for (i = 0; i < This->numfaces; i++)
+            sorted_data[face_order[i]] = i;
+        for (i = 0; i < This->numfaces; i++)
+            face_remap[i] = sorted_data[face_remap[i]];
+    }
+
+    HeapFree(GetProcessHeap(), 0, sorted_data);
+    HeapFree(GetProcessHeap(), 0, face_order);
+    return hr;
+}
+
 static HRESULT WINAPI d3dx9_mesh_OptimizeInplace(ID3DXMesh *iface, DWORD flags, const DWORD *adjacency_in,
         DWORD *adjacency_out, DWORD *face_remap_out, ID3DXBuffer **vertex_remap_out)
 {
@@ -1660,14 +2092,9 @@ static HRESULT WINAPI d3dx9_mesh_OptimizeInplace(ID3DXMesh *iface, DWORD flags,
     if ((flags & (D3DXMESHOPT_VERTEXCACHE | D3DXMESHOPT_STRIPREORDER)) == (D3DXMESHOPT_VERTEXCACHE | D3DXMESHOPT_STRIPREORDER))
         return D3DERR_INVALIDCALL;
 
+    /* Face reordering is done within attribute ranges. */
     if (flags & (D3DXMESHOPT_VERTEXCACHE | D3DXMESHOPT_STRIPREORDER))
-    {
-        if (flags & D3DXMESHOPT_VERTEXCACHE)
-            FIXME("D3DXMESHOPT_VERTEXCACHE not implemented.\n");
-        if (flags & D3DXMESHOPT_STRIPREORDER)
-            FIXME("D3DXMESHOPT_STRIPREORDER not implemented.\n");
-        return E_NOTIMPL;
-    }
+        flags |= D3DXMESHOPT_ATTRSORT;
 
     hr = iface->lpVtbl->LockIndexBuffer(iface, 0, &indices);
     if (FAILED(hr)) goto cleanup;
@@ -1688,14 +2115,25 @@ static HRESULT WINAPI d3dx9_mesh_OptimizeInplace(ID3DXMesh *iface, DWORD flags,
         hr = compact_mesh(This, dword_indices, &new_num_vertices, &vertex_remap);
         if (FAILED(hr)) goto cleanup;
     } else if (flags & D3DXMESHOPT_ATTRSORT) {
-        if (!(flags & D3DXMESHOPT_IGNOREVERTS))
-            FIXME("D3DXMESHOPT_ATTRSORT vertex reordering not implemented.\n");
-
         hr = iface->lpVtbl->LockAttributeBuffer(iface, 0, &attrib_buffer);
         if (FAILED(hr)) goto cleanup;
 
         hr = remap_faces_for_attrsort(This, dword_indices, attrib_buffer, &sorted_attrib_buffer, &face_remap);
         if (FAILED(hr)) goto cleanup;
+
+        if (flags & (D3DXMESHOPT_VERTEXCACHE | D3DXMESHOPT_STRIPREORDER))
+        {
+            hr = remap_faces_for_cache(This, flags, dword_indices, adjacency_in, sorted_attrib_buffer, face_remap);
+            if (FAILED(hr)) goto cleanup;
+        }
+
+        if (!(flags & D3DXMESHOPT_IGNOREVERTS))
+        {
+            new_num_alloc_vertices = This->numvertices;
+            hr = reorder_vertices(This, dword_indices, face_remap, flags & D3DXMESHOPT_COMPACT,
+                    &new_num_vertices, &vertex_remap);
+            if (FAILED(hr)) goto cleanup;
+        }
     }
 
     if (vertex_remap)
@@ -1788,9 +2226,11 @@ static HRESULT WINAPI d3dx9_mesh_OptimizeInplace(ID3DXMesh *iface, DWORD flags,
             for (i = 0; i < This->numfaces; i++) {
                 DWORD old_pos = i * 3;
                 DWORD new_pos = face_remap[i] * 3;
-                adjacency_out[new_pos++] = face_remap[adjacency_in[old_pos++]];
-                adjacency_out[new_pos++] = face_remap[adjacency_in[old_pos++]];
-                adjacency_out[new_pos++] = face_remap[adjacency_in[old_pos++]];
+                DWORD j;
+
+                for (j = 0; j < 3; j++, old_pos++, new_pos++)
+                    adjacency_out[new_pos] = adjacency_in[old_pos] < This->numfaces
+                            ? face_remap[adjacency_in[old_pos]] : -1;
             }
         } else {
             memcpy(adjacency_out, adjacency_in, This->numfaces * 3 * sizeof(*adjacency_out));
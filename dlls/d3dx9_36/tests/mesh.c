@@ -10542,6 +10542,147 @@ static void test_optimize_faces(void)
     ok(hr == D3DERR_INVALIDCALL, "Got unexpected hr %#x.\n", hr);
 }
 
+static void test_optimize_inplace(void)
+{
+    static const DWORD flags[] =
+    {
+        D3DXMESHOPT_ATTRSORT | D3DXMESHOPT_DONOTSPLIT,
+        D3DXMESHOPT_VERTEXCACHE | D3DXMESHOPT_DONOTSPLIT,
+        D3DXMESHOPT_VERTEXCACHE | D3DXMESHOPT_DEVICEINDEPENDENT | D3DXMESHOPT_DONOTSPLIT,
+        D3DXMESHOPT_STRIPREORDER | D3DXMESHOPT_DONOTSPLIT,
+        D3DXMESHOPT_VERTEXCACHE | D3DXMESHOPT_COMPACT | D3DXMESHOPT_DONOTSPLIT,
+    };
+    const D3DVERTEXELEMENT9 declaration[] =
+    {
+        {0, 0, D3DDECLTYPE_FLOAT3, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_POSITION, 0},
+        D3DDECL_END()
+    };
+    struct test_context *test_context;
+    DWORD adjacency[8 * 8 * 2 * 3];
+    DWORD attributes[8 * 8 * 2];
+    DWORD indices[8 * 8 * 2 * 3];
+    D3DXVECTOR3 vertices[9 * 9];
+    DWORD face_remap[8 * 8 * 2];
+    const DWORD num_faces = ARRAY_SIZE(attributes);
+    const DWORD num_vertices = ARRAY_SIZE(vertices);
+    ID3DXBuffer *vertex_remap;
+    DWORD *new_attributes;
+    DWORD *vertex_remap_ptr;
+    D3DXVECTOR3 *new_vertices;
+    DWORD *new_indices;
+    ID3DXMesh *mesh;
+    unsigned int i, j, k;
+    HRESULT hr;
+
+    if (!(test_context = new_test_context()))
+    {
+        skip("Couldn't create test context.\n");
+        return;
+    }
+
+    /* An 8x8 grid of quads, with the faces emitted in a scrambled order and
+     * alternating between two attributes. */
+    for (i = 0; i < 9; i++)
+    {
+        for (j = 0; j < 9; j++)
+        {
+            vertices[i * 9 + j].x = j;
+            vertices[i * 9 + j].y = i;
+            vertices[i * 9 + j].z = 0.0f;
+        }
+    }
+    for (i = 0; i < num_faces / 2; i++)
+    {
+        DWORD quad = (i * 37) % (num_faces / 2);
+        DWORD v = quad / 8 * 9 + quad % 8;
+
+        indices[i * 6 + 0] = v;
+        indices[i * 6 + 1] = v + 1;
+        indices[i * 6 + 2] = v + 9;
+        indices[i * 6 + 3] = v + 1;
+        indices[i * 6 + 4] = v + 10;
+        indices[i * 6 + 5] = v + 9;
+        attributes[i * 2] = attributes[i * 2 + 1] = i & 1;
+    }
+
+    for (i = 0; i < ARRAY_SIZE(flags); i++)
+    {
+        hr = init_test_mesh(num_faces, num_vertices, D3DXMESH_32BIT | D3DXMESH_SYSTEMMEM, declaration,
+                test_context->device, &mesh, vertices, sizeof(*vertices), indices, attributes);
+        if (FAILED(hr))
+        {
+            skip("Couldn't initialize test mesh %u, hr %#x.\n", i, hr);
+            continue;
+        }
+
+        hr = mesh->lpVtbl->GenerateAdjacency(mesh, 0.0f, adjacency);
+        ok(hr == D3D_OK, "Test %u: got unexpected hr %#x.\n", i, hr);
+
+        if (!i)
+        {
+            hr = mesh->lpVtbl->OptimizeInplace(mesh, D3DXMESHOPT_VERTEXCACHE, NULL, NULL, NULL, NULL);
+            ok(hr == D3DERR_INVALIDCALL, "Got unexpected hr %#x.\n", hr);
+            hr = mesh->lpVtbl->OptimizeInplace(mesh, D3DXMESHOPT_VERTEXCACHE | D3DXMESHOPT_STRIPREORDER,
+                    adjacency, NULL, NULL, NULL);
+            ok(hr == D3DERR_INVALIDCALL, "Got unexpected hr %#x.\n", hr);
+        }
+
+        hr = mesh->lpVtbl->OptimizeInplace(mesh, flags[i], adjacency, NULL, face_remap, &vertex_remap);
+        ok(hr == D3D_OK, "Test %u: got unexpected hr %#x.\n", i, hr);
+        if (FAILED(hr))
+        {
+            mesh->lpVtbl->Release(mesh);
+            continue;
+        }
+        ok(mesh->lpVtbl->GetNumFaces(mesh) == num_faces, "Test %u: got unexpected number of faces %u.\n",
+                i, mesh->lpVtbl->GetNumFaces(mesh));
+        ok(mesh->lpVtbl->GetNumVertices(mesh) == num_vertices, "Test %u: got unexpected number of vertices %u.\n",
+                i, mesh->lpVtbl->GetNumVertices(mesh));
+
+        mesh->lpVtbl->LockVertexBuffer(mesh, D3DLOCK_READONLY, (void **)&new_vertices);
+        mesh->lpVtbl->LockIndexBuffer(mesh, D3DLOCK_READONLY, (void **)&new_indices);
+        mesh->lpVtbl->LockAttributeBuffer(mesh, D3DLOCK_READONLY, &new_attributes);
+        vertex_remap_ptr = ID3DXBuffer_GetBufferPointer(vertex_remap);
+
+        for (j = 0; j < num_vertices; j++)
+        {
+            ok(vertex_remap_ptr[j] < num_vertices, "Test %u: got unexpected vertex remap %u at %u.\n",
+                    i, vertex_remap_ptr[j], j);
+            if (vertex_remap_ptr[j] < num_vertices)
+                ok(!memcmp(&new_vertices[j], &vertices[vertex_remap_ptr[j]], sizeof(*vertices)),
+                        "Test %u: got unexpected vertex %u.\n", i, j);
+        }
+
+        /* Faces are sorted by attribute and the new faces are the old ones. */
+        for (j = 0; j < num_faces; j++)
+        {
+            const DWORD *old_face = &indices[face_remap[j] * 3];
+            BOOL found = FALSE;
+
+            ok(face_remap[j] < num_faces, "Test %u: got unexpected face remap %u at %u.\n", i, face_remap[j], j);
+            if (face_remap[j] >= num_faces)
+                continue;
+            ok(!j || new_attributes[j] >= new_attributes[j - 1], "Test %u: attributes aren't sorted at %u.\n", i, j);
+            ok(new_attributes[j] == attributes[face_remap[j]], "Test %u: got unexpected attribute %u at %u.\n",
+                    i, new_attributes[j], j);
+
+            for (k = 0; k < 3 && !found; k++)
+                found = vertex_remap_ptr[new_indices[j * 3]] == old_face[k]
+                        && vertex_remap_ptr[new_indices[j * 3 + 1]] == old_face[(k + 1) % 3]
+                        && vertex_remap_ptr[new_indices[j * 3 + 2]] == old_face[(k + 2) % 3];
+            ok(found, "Test %u: face %u doesn't match old face %u.\n", i, j, face_remap[j]);
+        }
+
+        mesh->lpVtbl->UnlockAttributeBuffer(mesh);
+        mesh->lpVtbl->UnlockIndexBuffer(mesh);
+        mesh->lpVtbl->UnlockVertexBuffer(mesh);
+        ID3DXBuffer_Release(vertex_remap);
+        mesh->lpVtbl->Release(mesh);
+    }
+
+    free_test_context(test_context);
+}
+
 static HRESULT clear_normals(ID3DXMesh *mesh)
 {
     HRESULT hr;
@@ -11480,6 +11621,7 @@ START_TEST(mesh)
     test_clone_mesh();
     test_valid_mesh();
     test_optimize_faces();
+    test_optimize_inplace();
     test_compute_normals();
     test_D3DXFrameFind();
     test_load_skin_mesh_from_xof();
@@ -2779,6 +2779,23 @@ static void* pdb_ds_read(const struct PDB_DS_HEADER* pdb, const DWORD* block_lis
     return buffer;
 }
 
+/* returns a pointer inside the mapped image if the stream's blocks are contiguous */
+static void* pdb_ds_map(const struct PDB_DS_HEADER* pdb, const DWORD* block_list,
+                        int size)
+{
+    int                         i, num_blocks;
+
+    if (!size) return NULL;
+
+    num_blocks = (size + pdb->block_size - 1) / pdb->block_size;
+    if (block_list[0] >= pdb->num_pages || pdb->num_pages - block_list[0] < num_blocks)
+        return NULL;
+    for (i = 1; i < num_blocks; i++)
+        if (block_list[i] != block_list[0] + i) return NULL;
+
+    return (char*)pdb + block_list[0] * pdb->block_size;
+}
+
 static void* pdb_read_jg_file(const struct PDB_JG_HEADER* pdb,
                               const struct PDB_JG_TOC* toc, DWORD file_nr)
 {
@@ -2795,10 +2812,11 @@ static void* pdb_read_jg_file(const struct PDB_JG_HEADER* pdb,
 }
 
 static void* pdb_read_ds_file(const struct PDB_DS_HEADER* pdb,
-                              const struct PDB_DS_TOC* toc, DWORD file_nr)
+                              const struct PDB_DS_TOC* toc, DWORD file_nr, BOOL map)
 {
     const DWORD*                block_list;
     DWORD                       i;
+    void*                       ret;
 
     if (!toc || file_nr >= toc->num_files) return NULL;
     if (toc->file_size[file_nr] == 0 || toc->file_size[file_nr] == 0xFFFFFFFF) return NULL;
@@ -2807,6 +2825,7 @@ static void* pdb_read_ds_file(const struct PDB_DS_HEADER* pdb,
     for (i = 0; i < file_nr; i++)
         block_list += (toc->file_size[i] + pdb->block_size - 1) / pdb->block_size;
 
+    if (map && (ret = pdb_ds_map(pdb, block_list, toc->file_size[file_nr]))) return ret;
     return pdb_ds_read(pdb, block_list, toc->file_size[file_nr]);
 }
 
@@ -2820,7 +2839,7 @@ static void* pdb_read_file(const struct pdb_file_info* pdb_file,
                                 pdb_file->u.jg.toc, file_nr);
     case PDB_DS:
         return pdb_read_ds_file((const struct PDB_DS_HEADER*)pdb_file->image,
-                                pdb_file->u.ds.toc, file_nr);
+                                pdb_file->u.ds.toc, file_nr, TRUE);
     }
     return NULL;
 }
@@ -2840,6 +2859,20 @@ static void pdb_free(void* buffer)
     HeapFree(GetProcessHeap(), 0, buffer);
 }
 
+/* releases a buffer returned by pdb_read_file() */
+static void pdb_free_file_data(const struct pdb_file_info* pdb_file, void* buffer)
+{
+    if (pdb_file->kind == PDB_DS)
+    {
+        const struct PDB_DS_HEADER* pdb = (const struct PDB_DS_HEADER*)pdb_file->image;
+
+        if ((const char*)buffer >= pdb_file->image &&
+            (const char*)buffer < pdb_file->image + (SIZE_T)pdb->num_pages * pdb->block_size)
+            return;
+    }
+    pdb_free(buffer);
+}
+
 static void pdb_free_file(struct pdb_file_info* pdb_file)
 {
     switch (pdb_file->kind)
@@ -2918,7 +2951,7 @@ static void* pdb_read_strings(const struct pdb_file_info* pdb_file)
     {
         ret = pdb_read_file( pdb_file, idx );
         if (ret && *(const DWORD *)ret == 0xeffeeffe) return ret;
-        pdb_free( ret );
+        pdb_free_file_data( pdb_file, ret );
     }
     WARN("string table not found\n");
     return NULL;
@@ -3105,7 +3138,7 @@ static void pdb_process_types(const struct msc_debug_info* msc_dbg,
             codeview_parse_type_table(&ctp);
             HeapFree(GetProcessHeap(), 0, (DWORD*)ctp.offset);
         }
-        pdb_free(types_image);
+        pdb_free_file_data(pdb_file, types_image);
     }
 }
 
@@ -3182,7 +3215,7 @@ static BOOL pdb_init(const struct pdb_lookup* pdb_lookup, struct pdb_file_info*
             pdb_ds_read(pdb, 
                         (const DWORD*)((const char*)pdb + pdb->toc_page * pdb->block_size), 
                         pdb->toc_size);
-        root = pdb_read_ds_file(pdb, pdb_file->u.ds.toc, 1);
+        root = pdb_read_ds_file(pdb, pdb_file->u.ds.toc, 1, FALSE);
         if (!root)
         {
             ERR("-Unable to get root from .PDB in %s\n", pdb_lookup->filename);
@@ -3228,7 +3261,7 @@ static BOOL pdb_init(const struct pdb_lookup* pdb_lookup, struct pdb_file_info*
             FIXME("********************** [%u]: size=%08x\n",
                   i, pdb_get_file_size(pdb_file, i));
             dump(x, pdb_get_file_size(pdb_file, i));
-            pdb_free(x);
+            pdb_free_file_data(pdb_file, x);
         }
     }
     return ret;
@@ -3406,7 +3439,6 @@ static BOOL pdb_process_internal(const struct process* pcs,
             const char*                 file_name;
             unsigned                    size;
 
-            HeapValidate(GetProcessHeap(), 0, NULL);
             pdb_convert_symbol_file(&symbols, &sfile, &size, file);
 
             modimage = pdb_read_file(pdb_file, sfile.file);
@@ -3425,7 +3457,7 @@ static BOOL pdb_process_internal(const struct process* pcs,
                                            sfile.lineno_size,
                                            pdb_file->kind == PDB_JG);
 
-                pdb_free(modimage);
+                pdb_free_file_data(pdb_file, modimage);
             }
             file_name = (const char*)file + size;
             file_name += strlen(file_name) + 1;
@@ -3436,17 +3468,17 @@ static BOOL pdb_process_internal(const struct process* pcs,
         {
             codeview_snarf_public(msc_dbg, globalimage, 0,
                                   pdb_get_file_size(pdb_file, symbols.gsym_file));
-            pdb_free(globalimage);
+            pdb_free_file_data(pdb_file, globalimage);
         }
         HeapFree(GetProcessHeap(), 0, (DWORD*)ipi_ctp.offset);
-        pdb_free(ipi_image);
+        pdb_free_file_data(pdb_file, ipi_image);
     }
     else
         pdb_process_symbol_imports(pcs, msc_dbg, NULL, NULL, image,
                                    pdb_lookup, pdb_module_info, module_index);
 
-    pdb_free(symbols_image);
-    pdb_free(files_image);
+    pdb_free_file_data(pdb_file, symbols_image);
+    pdb_free_file_data(pdb_file, files_image);
 
     return TRUE;
 }
@@ -3832,8 +3864,8 @@ BOOL pdb_virtual_unwind(struct cpu_stack_walk *csw, DWORD_PTR ip,
         }
     }
     else ret = FALSE;
-    pdb_free(fpoext);
-    pdb_free(strbase);
+    pdb_free_file_data(&pdb_info->pdb_files[0], fpoext);
+    pdb_free_file_data(&pdb_info->pdb_files[0], strbase);
 
     return ret;
 }
@@ -125,6 +125,8 @@ static inline char *strdup_ua( const char *src )
 }
 
 extern const char *debugstr_type( unsigned short ) DECLSPEC_HIDDEN;
+extern void cache_flush( const char * ) DECLSPEC_HIDDEN;
+extern BOOL get_negative_ttl( const DNS_MESSAGE_BUFFER *, WORD, DWORD * ) DECLSPEC_HIDDEN;
 
 struct get_searchlist_params
 {
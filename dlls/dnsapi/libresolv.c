@@ -90,12 +90,6 @@ static unsigned long map_options( DWORD options )
         FIXME( "option DNS_QUERY_DONT_RESET_TTL_VALUES not implemented\n" );
     if (options & DNS_QUERY_RESERVED)
         FIXME( "option DNS_QUERY_RESERVED not implemented\n" );
-    if (options & DNS_QUERY_WIRE_ONLY)
-        FIXME( "option DNS_QUERY_WIRE_ONLY not implemented\n" );
-    if (options & DNS_QUERY_NO_WIRE_QUERY)
-        FIXME( "option DNS_QUERY_NO_WIRE_QUERY not implemented\n" );
-    if (options & DNS_QUERY_BYPASS_CACHE)
-        FIXME( "option DNS_QUERY_BYPASS_CACHE not implemented\n" );
     if (options & DNS_QUERY_RETURN_MESSAGE)
         FIXME( "option DNS_QUERY_RETURN_MESSAGE not implemented\n" );
 
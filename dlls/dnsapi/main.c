@@ -97,7 +97,8 @@ DNS_STATUS WINAPI DnsAcquireContextHandle_W( DWORD flags, PVOID cred,
  */
 VOID WINAPI DnsFlushResolverCache(void)
 {
-    FIXME(": stub\n");
+    TRACE( "\n" );
+    cache_flush( NULL );
 }
 
 /******************************************************************************
@@ -106,8 +107,13 @@ VOID WINAPI DnsFlushResolverCache(void)
  */
 BOOL WINAPI DnsFlushResolverCacheEntry_A( PCSTR entry )
 {
-    FIXME( "%s: stub\n", debugstr_a(entry) );
+    char *entryU;
+
+    TRACE( "%s\n", debugstr_a(entry) );
     if (!entry) return FALSE;
+    if (!(entryU = strdup_au( entry ))) return FALSE;
+    cache_flush( entryU );
+    free( entryU );
     return TRUE;
 }
 
@@ -117,8 +123,9 @@ BOOL WINAPI DnsFlushResolverCacheEntry_A( PCSTR entry )
  */
 BOOL WINAPI DnsFlushResolverCacheEntry_UTF8( PCSTR entry )
 {
-    FIXME( "%s: stub\n", debugstr_a(entry) );
+    TRACE( "%s\n", debugstr_a(entry) );
     if (!entry) return FALSE;
+    cache_flush( entry );
     return TRUE;
 }
 
@@ -128,8 +135,13 @@ BOOL WINAPI DnsFlushResolverCacheEntry_UTF8( PCSTR entry )
  */
 BOOL WINAPI DnsFlushResolverCacheEntry_W( PCWSTR entry )
 {
-    FIXME( "%s: stub\n", debugstr_w(entry) );
+    char *entryU;
+
+    TRACE( "%s\n", debugstr_w(entry) );
     if (!entry) return FALSE;
+    if (!(entryU = strdup_wu( entry ))) return FALSE;
+    cache_flush( entryU );
+    free( entryU );
     return TRUE;
 }
 
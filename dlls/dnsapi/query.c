@@ -19,6 +19,7 @@
  */
 
 #include <stdarg.h>
+#include <string.h>
 #include "windef.h"
 #include "winbase.h"
 #include "winerror.h"
@@ -28,12 +29,159 @@
 #include "ws2def.h"
 
 #include "wine/debug.h"
+#include "wine/list.h"
 #include "dnsapi.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(dnsapi);
 
 #define DEFAULT_TTL  1200
 
+/* Limits used by the Windows DNS client service (MaxCacheTtl, MaxNegativeCacheTtl) */
+#define MAX_CACHE_TTL           86400
+#define MAX_NEGATIVE_CACHE_TTL  900
+#define MAX_CACHE_ENTRIES       1024
+
+/* options that change the answer returned by the resolver */
+#define CACHE_KEY_OPTIONS (DNS_QUERY_ACCEPT_TRUNCATED_RESPONSE | DNS_QUERY_USE_TCP_ONLY | \
+                           DNS_QUERY_NO_RECURSION | DNS_QUERY_NO_LOCAL_NAME | \
+                           DNS_QUERY_NO_HOSTS_FILE | DNS_QUERY_TREAT_AS_FQDN)
+
+struct cache_entry
+{
+    struct list  entry;
+    char        *name;
+    WORD         type;
+    DWORD        options;   /* CACHE_KEY_OPTIONS of the query */
+    DNS_STATUS   status;
+    DNS_RECORDA *records;   /* UTF-8, NULL for negative entries */
+    ULONGLONG    added;
+    ULONGLONG    expires;
+};
+
+static struct list cache = LIST_INIT( cache );
+static unsigned int cache_count;
+
+static CRITICAL_SECTION cache_cs;
+static CRITICAL_SECTION_DEBUG cache_cs_debug =
+{
+    0, 0, &cache_cs,
+    { &cache_cs_debug.ProcessLocksList, &cache_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": cache_cs") }
+};
+static CRITICAL_SECTION cache_cs = { &cache_cs_debug, -1, 0, 0, 0, 0 };
+
+static void free_cache_entry( struct cache_entry *entry )
+{
+    list_remove( &entry->entry );
+    cache_count--;
+    DnsRecordListFree( (DNS_RECORD *)entry->records, DnsFreeRecordList );
+    free( entry->name );
+    free( entry );
+}
+
+/* Must be called with cache_cs held. */
+static struct cache_entry *find_cache_entry( const char *name, WORD type, DWORD options )
+{
+    struct cache_entry *entry, *next;
+    ULONGLONG now = GetTickCount64();
+
+    LIST_FOR_EACH_ENTRY_SAFE( entry, next, &cache, struct cache_entry, entry )
+    {
+        if (entry->expires <= now)
+        {
+            free_cache_entry( entry );
+            continue;
+        }
+        if (entry->type == type && entry->options == options && !_stricmp( entry->name, name ))
+            return entry;
+    }
+    return NULL;
+}
+
+static BOOL cache_lookup( const char *name, WORD type, DWORD options, DNS_RECORDA **result,
+                          DNS_STATUS *status )
+{
+    struct cache_entry *entry;
+    DNS_RECORDA *rec;
+    DWORD elapsed;
+    BOOL ret = FALSE;
+
+    EnterCriticalSection( &cache_cs );
+    if ((entry = find_cache_entry( name, type, options & CACHE_KEY_OPTIONS )))
+    {
+        *status = entry->status;
+        *result = NULL;
+        if (entry->records && !(*result = (DNS_RECORDA *)DnsRecordSetCopyEx( (DNS_RECORD *)entry->records,
+                                                                             DnsCharSetUtf8, DnsCharSetUtf8 )))
+            *status = ERROR_NOT_ENOUGH_MEMORY;
+
+        /* report the time to live remaining */
+        elapsed = (GetTickCount64() - entry->added) / 1000;
+        for (rec = *result; rec; rec = rec->pNext) rec->dwTtl = rec->dwTtl > elapsed ? rec->dwTtl - elapsed : 0;
+
+        list_remove( &entry->entry );
+        list_add_head( &cache, &entry->entry );
+        ret = TRUE;
+    }
+    LeaveCriticalSection( &cache_cs );
+
+    if (ret) TRACE( "found %s %s in cache, status %u\n", debugstr_a(name), debugstr_type( type ), *status );
+    return ret;
+}
+
+/* ttl is only used for negative entries, positive ones expire with their records */
+static void cache_insert( const char *name, WORD type, DWORD options, DNS_STATUS status,
+                          DNS_RECORDA *records, DWORD ttl )
+{
+    struct cache_entry *entry, *old;
+    DNS_RECORDA *rec;
+
+    if (records) ttl = MAX_CACHE_TTL;
+    else ttl = min( ttl, MAX_NEGATIVE_CACHE_TTL );
+    for (rec = records; rec; rec = rec->pNext) ttl = min( ttl, rec->dwTtl );
+    if (!ttl) return;
+
+    if (!(entry = malloc( sizeof(*entry) ))) return;
+    if (!(entry->name = strdup_u( name )))
+    {
+        free( entry );
+        return;
+    }
+    entry->records = NULL;
+    if (records && !(entry->records = (DNS_RECORDA *)DnsRecordSetCopyEx( (DNS_RECORD *)records,
+                                                                         DnsCharSetUtf8, DnsCharSetUtf8 )))
+    {
+        free( entry->name );
+        free( entry );
+        return;
+    }
+    entry->type = type;
+    entry->options = options & CACHE_KEY_OPTIONS;
+    entry->status = status;
+    entry->added = GetTickCount64();
+    entry->expires = entry->added + ttl * 1000;
+
+    EnterCriticalSection( &cache_cs );
+    if ((old = find_cache_entry( name, type, entry->options ))) free_cache_entry( old );
+    list_add_head( &cache, &entry->entry );
+    if (++cache_count > MAX_CACHE_ENTRIES)
+        free_cache_entry( LIST_ENTRY( list_tail( &cache ), struct cache_entry, entry ) );
+    LeaveCriticalSection( &cache_cs );
+}
+
+/* Flushes the entries for name, or the whole cache if name is NULL. */
+void cache_flush( const char *name )
+{
+    struct cache_entry *entry, *next;
+
+    EnterCriticalSection( &cache_cs );
+    LIST_FOR_EACH_ENTRY_SAFE( entry, next, &cache, struct cache_entry, entry )
+    {
+        if (!name || !_stricmp( entry->name, name )) free_cache_entry( entry );
+    }
+    LeaveCriticalSection( &cache_cs );
+}
+
 static DNS_STATUS do_query_netbios( PCSTR name, DNS_RECORDA **recp )
 {
     NCB ncb;
@@ -169,8 +317,10 @@ DNS_STATUS WINAPI DnsQuery_UTF8( PCSTR name, WORD type, DWORD options, PVOID ser
 {
     DNS_STATUS ret = DNS_ERROR_RCODE_NOT_IMPLEMENTED;
     unsigned char answer[4096];
-    DWORD len = sizeof(answer);
+    DWORD len = sizeof(answer), ttl;
     struct query_params query_params = { name, type, options, answer, &len };
+    DNS_MESSAGE_BUFFER *buffer = (DNS_MESSAGE_BUFFER *)answer;
+    BOOL use_cache;
 
     TRACE( "(%s,%s,0x%08x,%p,%p,%p)\n", debugstr_a(name), debugstr_type( type ),
            options, servers, result, reserved );
@@ -178,13 +328,27 @@ DNS_STATUS WINAPI DnsQuery_UTF8( PCSTR name, WORD type, DWORD options, PVOID ser
     if (!name || !result)
         return ERROR_INVALID_PARAMETER;
 
+    if (options & DNS_QUERY_NO_WIRE_QUERY)
+    {
+        if (cache_lookup( name, type, options, result, &ret )) return ret;
+        return DNS_ERROR_RECORD_DOES_NOT_EXIST;
+    }
+
+    /* Queries sent to specific servers aren't answered from or stored in the cache */
+    use_cache = !servers && !(options & (DNS_QUERY_BYPASS_CACHE | DNS_QUERY_WIRE_ONLY));
+    if (use_cache && cache_lookup( name, type, options, result, &ret )) goto done;
+
     if ((ret = RESOLV_CALL( set_serverlist, servers ))) return ret;
 
-    ret = RESOLV_CALL( query, &query_params );
-    if (!ret)
+    /* the resolver leaves negative responses in the buffer, this tells them apart
+     * from failures to get any response */
+    memset( &buffer->MessageHead, 0, sizeof(buffer->MessageHead) );
+    if ((ret = RESOLV_CALL( query, &query_params )))
+    {
+        DNS_BYTE_FLIP_HEADER_COUNTS( &buffer->MessageHead );
+    }
+    else
     {
-        DNS_MESSAGE_BUFFER *buffer = (DNS_MESSAGE_BUFFER *)answer;
-
         if (len < sizeof(buffer->MessageHead)) return DNS_ERROR_BAD_PACKET;
         DNS_BYTE_FLIP_HEADER_COUNTS( &buffer->MessageHead );
         switch (buffer->MessageHead.ResponseCode)
@@ -204,6 +368,17 @@ DNS_STATUS WINAPI DnsQuery_UTF8( PCSTR name, WORD type, DWORD options, PVOID ser
         }
     }
 
+    if (use_cache)
+    {
+        if (!ret) cache_insert( name, type, options, ret, *result, 0 );
+        else if (ret == DNS_ERROR_RCODE_NAME_ERROR || ret == DNS_INFO_NO_RECORDS)
+        {
+            /* negative answers without an SOA record must not be cached */
+            if (get_negative_ttl( buffer, len, &ttl )) cache_insert( name, type, options, ret, NULL, ttl );
+        }
+    }
+
+done:
     if (ret == DNS_ERROR_RCODE_NAME_ERROR && type == DNS_TYPE_A &&
         !(options & DNS_QUERY_NO_NETBT))
     {
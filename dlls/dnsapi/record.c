@@ -1165,6 +1165,49 @@ static DNS_STATUS extract_message_records( const DNS_MESSAGE_BUFFER *buffer, WOR
     return ret;
 }
 
+/* Gets the time a negative answer may be cached for from the SOA record in its
+ * authority section, as described in RFC 2308. */
+BOOL get_negative_ttl( const DNS_MESSAGE_BUFFER *buffer, WORD len, DWORD *ttl )
+{
+    const DNS_HEADER *hdr = &buffer->MessageHead;
+    const BYTE *end = (const BYTE *)hdr + len;
+    const BYTE *ptr = (const BYTE *)buffer->MessageBody;
+    const BYTE *rdata;
+    unsigned int num;
+    WORD type, rdlen;
+    DWORD soa_ttl, minimum;
+
+    if (len < sizeof(*hdr) || !hdr->IsResponse) return FALSE;
+
+    for (num = 0; num < hdr->QuestionCount; num++)
+        if (!(ptr = skip_record( ptr, end, DnsSectionQuestion ))) return FALSE;
+
+    for (num = 0; num < hdr->AnswerCount; num++)
+        if (!(ptr = skip_record( ptr, end, DnsSectionAnswer ))) return FALSE;
+
+    for (num = 0; num < hdr->NameServerCount; num++)
+    {
+        if (!(ptr = skip_name( ptr, end ))) return FALSE;
+        if (ptr + 10 > end) return FALSE;
+        type = get_word( &ptr );
+        ptr += sizeof(WORD); /* class */
+        soa_ttl = get_dword( &ptr );
+        rdlen = get_word( &ptr );
+        if (ptr + rdlen > end) return FALSE;
+
+        /* the minimum field is the last one, after two names and four other fields */
+        if (type == DNS_TYPE_SOA && rdlen >= 2 + 5 * sizeof(DWORD))
+        {
+            rdata = ptr + rdlen - sizeof(DWORD);
+            minimum = get_dword( &rdata );
+            *ttl = min( soa_ttl, minimum );
+            return TRUE;
+        }
+        ptr += rdlen;
+    }
+    return FALSE;
+}
+
 /******************************************************************************
  * DnsExtractRecordsFromMessage_UTF8       [DNSAPI.@]
  *
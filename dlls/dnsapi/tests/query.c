@@ -31,6 +31,9 @@
 
 #define NS_MAXDNAME 1025
 
+static void (WINAPI *pDnsFlushResolverCache)(void);
+static BOOL (WINAPI *pDnsFlushResolverCacheEntry_W)(const WCHAR *);
+
 static void test_DnsQuery(void)
 {
     WCHAR domain[MAX_PATH];
@@ -119,6 +122,59 @@ static void test_DnsQuery(void)
     }
 }
 
+static void test_DnsQuery_cache(void)
+{
+    DNS_RECORDW *rec;
+    DNS_STATUS status;
+
+    if (!pDnsFlushResolverCache || !pDnsFlushResolverCacheEntry_W)
+    {
+        win_skip("DnsFlushResolverCache not available\n");
+        return;
+    }
+    pDnsFlushResolverCache();
+
+    rec = NULL;
+    status = DnsQuery_W(L"winehq.org", DNS_TYPE_A, DNS_QUERY_STANDARD, NULL, &rec, NULL);
+    if (status == ERROR_TIMEOUT)
+    {
+        skip("query timed out\n");
+        return;
+    }
+    ok(status == ERROR_SUCCESS, "got %d\n", status);
+    DnsRecordListFree(rec, DnsFreeRecordList);
+
+    /* answered from the cache */
+    rec = NULL;
+    status = DnsQuery_W(L"winehq.org", DNS_TYPE_A, DNS_QUERY_NO_WIRE_QUERY, NULL, &rec, NULL);
+    ok(status == ERROR_SUCCESS, "got %d\n", status);
+    ok(rec != NULL, "got no records\n");
+    if (rec) ok(rec->wType == DNS_TYPE_A, "got type %u\n", rec->wType);
+    DnsRecordListFree(rec, DnsFreeRecordList);
+
+    rec = NULL;
+    status = DnsQuery_W(L"winehq.org", DNS_TYPE_A, DNS_QUERY_BYPASS_CACHE, NULL, &rec, NULL);
+    ok(status == ERROR_SUCCESS, "got %d\n", status);
+    DnsRecordListFree(rec, DnsFreeRecordList);
+
+    ok(pDnsFlushResolverCacheEntry_W(L"winehq.org"), "DnsFlushResolverCacheEntry_W failed\n");
+    rec = NULL;
+    status = DnsQuery_W(L"winehq.org", DNS_TYPE_A, DNS_QUERY_NO_WIRE_QUERY, NULL, &rec, NULL);
+    ok(status != ERROR_SUCCESS, "got %d\n", status);
+    if (!status) DnsRecordListFree(rec, DnsFreeRecordList);
+
+    rec = NULL;
+    status = DnsQuery_W(L"winehq.org", DNS_TYPE_A, DNS_QUERY_STANDARD, NULL, &rec, NULL);
+    ok(status == ERROR_SUCCESS, "got %d\n", status);
+    DnsRecordListFree(rec, DnsFreeRecordList);
+
+    pDnsFlushResolverCache();
+    rec = NULL;
+    status = DnsQuery_W(L"winehq.org", DNS_TYPE_A, DNS_QUERY_NO_WIRE_QUERY, NULL, &rec, NULL);
+    ok(status != ERROR_SUCCESS, "got %d\n", status);
+    if (!status) DnsRecordListFree(rec, DnsFreeRecordList);
+}
+
 static IP_ADAPTER_ADDRESSES *get_adapters(void)
 {
     ULONG err, size = 1024;
@@ -225,10 +281,15 @@ static void test_DnsQueryConfig( void )
 
 START_TEST(query)
 {
+    HMODULE module = GetModuleHandleA("dnsapi.dll");
     WSADATA data;
 
+    pDnsFlushResolverCache = (void *)GetProcAddress(module, "DnsFlushResolverCache");
+    pDnsFlushResolverCacheEntry_W = (void *)GetProcAddress(module, "DnsFlushResolverCacheEntry_W");
+
     WSAStartup(MAKEWORD(2, 2), &data);
 
     test_DnsQuery();
+    test_DnsQuery_cache();
     test_DnsQueryConfig();
 }
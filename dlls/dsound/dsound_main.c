@@ -92,6 +92,7 @@ const WCHAR wine_vxd_drv[] = L"winemm.vxd";
 
 /* All default settings, you most likely don't want to touch these, see wiki on UsefulRegistryKeys */
 int ds_hel_buflen = 32768 * 2;
+int ds_parallel_mix_buffers = 16;
 
 /*
  * Get a config key from either the app-specific or the default config
@@ -143,10 +144,17 @@ void setup_dsound_options(void)
     if (!get_config_key( hkey, appkey, "HelBuflen", buffer, MAX_PATH ))
         ds_hel_buflen = atoi(buffer);
 
+    if (!get_config_key( hkey, appkey, "ParallelMixBuffers", buffer, MAX_PATH ))
+    {
+        ds_parallel_mix_buffers = atoi(buffer);
+        if (ds_parallel_mix_buffers < 0) ds_parallel_mix_buffers = 0;
+    }
+
     if (appkey) RegCloseKey( appkey );
     if (hkey) RegCloseKey( hkey );
 
     TRACE("ds_hel_buflen = %d\n", ds_hel_buflen);
+    TRACE("ds_parallel_mix_buffers = %d\n", ds_parallel_mix_buffers);
 }
 
 static const char * get_device_id(LPCGUID pGuid)
@@ -35,6 +35,7 @@
 #define DS_MAX_CHANNELS 6
 
 extern int ds_hel_buflen DECLSPEC_HIDDEN;
+extern int ds_parallel_mix_buffers DECLSPEC_HIDDEN;
 
 /*****************************************************************************
  * Predeclare the interface implementation structures
@@ -88,8 +89,13 @@ struct DirectSoundDevice
     int                         speaker_num[DS_MAX_CHANNELS];
     int                         num_speakers;
     int                         lfe_channel;
-    float *tmp_buffer, *cp_buffer;
-    DWORD                       tmp_buffer_len, cp_buffer_len;
+
+    /* secondary buffers being mixed, rendered by mix_work when there are many */
+    IDirectSoundBufferImpl    **mix_buffers;
+    int                         mix_buffers_size, mix_count;
+    LONG                        mix_next;
+    DWORD                       mix_frames, mix_workers;
+    PTP_WORK                    mix_work;
 
     DSVOLUMEPAN                 volpan;
 
@@ -172,6 +178,12 @@ struct IDirectSoundBufferImpl
     bitsputfunc put, put_aux;
     int                         num_filters;
     DSFilter*                   filters;
+    /* resampler scratch space and mixer output, before it is summed into the device buffer */
+    float *tmp_buffer, *cp_buffer;
+    DWORD                       tmp_buffer_len, cp_buffer_len;
+    /* result of the last render, summed and notified by the mixer thread */
+    BOOL                        mix_rendered, mix_audible, mix_notify;
+    DWORD                       mix_notify_pos, mix_notify_len;
 
     struct list entry;
 };
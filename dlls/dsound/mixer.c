@@ -311,6 +311,26 @@ static UINT cp_fields_noresample(IDirectSoundBufferImpl *dsb, UINT count)
     return count;
 }
 
+/* Evaluates one FIR output. Four independent partial sums avoid a serial
+ * dependency on a single accumulator and map onto SIMD registers. */
+static inline float fir_dot(const float *coeffs, const float *samples, UINT count)
+{
+    float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+    UINT i;
+
+    for (i = 0; i + 4 <= count; i += 4)
+    {
+        sum0 += coeffs[i] * samples[i];
+        sum1 += coeffs[i + 1] * samples[i + 1];
+        sum2 += coeffs[i + 2] * samples[i + 2];
+        sum3 += coeffs[i + 3] * samples[i + 3];
+    }
+    for (; i < count; i++)
+        sum0 += coeffs[i] * samples[i];
+
+    return (sum0 + sum1) + (sum2 + sum3);
+}
+
 static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *freqAccNum)
 {
     UINT i, channel;
@@ -337,15 +357,15 @@ static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *
     if (!secondarybuffer_is_audible(dsb))
         return max_ipos;
 
-    if (!dsb->device->cp_buffer) {
-        dsb->device->cp_buffer = HeapAlloc(GetProcessHeap(), 0, len);
-        dsb->device->cp_buffer_len = len;
-    } else if (len > dsb->device->cp_buffer_len) {
-        dsb->device->cp_buffer = HeapReAlloc(GetProcessHeap(), 0, dsb->device->cp_buffer, len);
-        dsb->device->cp_buffer_len = len;
+    if (!dsb->cp_buffer) {
+        dsb->cp_buffer = HeapAlloc(GetProcessHeap(), 0, len);
+        dsb->cp_buffer_len = len;
+    } else if (len > dsb->cp_buffer_len) {
+        dsb->cp_buffer = HeapReAlloc(GetProcessHeap(), 0, dsb->cp_buffer, len);
+        dsb->cp_buffer_len = len;
     }
 
-    fir_copy = dsb->device->cp_buffer;
+    fir_copy = dsb->cp_buffer;
     intermediate = fir_copy + fir_cachesize;
 
     if(dsb->use_committed) {
@@ -373,24 +393,21 @@ static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *
         UINT ipos = int_fir_steps / dsbfirstep;
 
         UINT idx = (ipos + 1) * dsbfirstep - int_fir_steps - 1;
-        float rem = int_fir_steps + 1.0 - total_fir_steps;
+        float rem = int_fir_steps + 1.0f - total_fir_steps;
 
-        int fir_used = 0;
+        /* The interpolated coefficients are shared by all channels. */
+        UINT fir_used = 0;
         while (idx < fir_len - 1) {
-            fir_copy[fir_used++] = fir[idx] * (1.0 - rem) + fir[idx + 1] * rem;
-            idx += dsb->firstep;
+            fir_copy[fir_used++] = fir[idx] * (1.0f - rem) + fir[idx + 1] * rem;
+            idx += dsbfirstep;
         }
 
         assert(fir_used <= fir_cachesize);
         assert(ipos + fir_used <= required_input);
 
-        for (channel = 0; channel < dsb->mix_channels; channel++) {
-            int j;
-            float sum = 0.0;
+        for (channel = 0; channel < channels; channel++) {
             float* cache = &intermediate[channel * required_input + ipos];
-            for (j = 0; j < fir_used; j++)
-                sum += fir_copy[j] * cache[j];
-            dsb->put(dsb, i * ostride, channel, sum * dsb->firgain);
+            dsb->put(dsb, i * ostride, channel, fir_dot(fir_copy, cache, fir_used) * dsb->firgain);
         }
     }
 
@@ -459,23 +476,23 @@ static void DSOUND_MixToTemporary(IDirectSoundBufferImpl *dsb, DWORD frames)
 	HRESULT hr;
 	int i;
 
-	if (dsb->device->tmp_buffer_len < size_bytes || !dsb->device->tmp_buffer)
+	if (dsb->tmp_buffer_len < size_bytes || !dsb->tmp_buffer)
 	{
-		dsb->device->tmp_buffer_len = size_bytes;
-		if (dsb->device->tmp_buffer)
-			dsb->device->tmp_buffer = HeapReAlloc(GetProcessHeap(), 0, dsb->device->tmp_buffer, size_bytes);
+		dsb->tmp_buffer_len = size_bytes;
+		if (dsb->tmp_buffer)
+			dsb->tmp_buffer = HeapReAlloc(GetProcessHeap(), 0, dsb->tmp_buffer, size_bytes);
 		else
-			dsb->device->tmp_buffer = HeapAlloc(GetProcessHeap(), 0, size_bytes);
+			dsb->tmp_buffer = HeapAlloc(GetProcessHeap(), 0, size_bytes);
 	}
 	if(dsb->put_aux == putieee32_sum)
-		memset(dsb->device->tmp_buffer, 0, dsb->device->tmp_buffer_len);
+		memset(dsb->tmp_buffer, 0, dsb->tmp_buffer_len);
 
 	cp_fields(dsb, frames, &dsb->freqAccNum);
 
 	if (size_bytes > 0) {
 		for (i = 0; i < dsb->num_filters; i++) {
 			if (dsb->filters[i].inplace) {
-				hr = IMediaObjectInPlace_Process(dsb->filters[i].inplace, size_bytes, (BYTE*)dsb->device->tmp_buffer, 0, DMO_INPLACE_NORMAL);
+				hr = IMediaObjectInPlace_Process(dsb->filters[i].inplace, size_bytes, (BYTE*)dsb->tmp_buffer, 0, DMO_INPLACE_NORMAL);
 
 				if (FAILED(hr))
 					WARN("IMediaObjectInPlace_Process failed for filter %u\n", i);
@@ -511,7 +528,7 @@ static void DSOUND_MixerVol(const IDirectSoundBufferImpl *dsb, INT frames)
 
 	for(i = 0; i < frames; ++i){
 		for(chan = 0; chan < channels; ++chan){
-			dsb->device->tmp_buffer[i * channels + chan] *= vols[chan];
+			dsb->tmp_buffer[i * channels + chan] *= vols[chan];
 		}
 	}
 }
@@ -526,11 +543,11 @@ static void DSOUND_MixerVol(const IDirectSoundBufferImpl *dsb, INT frames)
  * (and it is not looping).
  *
  * dsb  = the secondary buffer to mix from
+ * mix_buffer = the device buffer, or NULL to leave the data in dsb->tmp_buffer
  * fraglen = number of bytes to mix
  */
 static DWORD DSOUND_MixInBuffer(IDirectSoundBufferImpl *dsb, float *mix_buffer, DWORD frames)
 {
-	float *ibuf;
 	DWORD oldpos;
 
 	TRACE("sec_mixpos=%d/%d\n", dsb->sec_mixpos, dsb->buflen);
@@ -539,20 +556,24 @@ static DWORD DSOUND_MixInBuffer(IDirectSoundBufferImpl *dsb, float *mix_buffer,
 	/* Resample buffer to temporary buffer specifically allocated for this purpose, if needed */
 	oldpos = dsb->sec_mixpos;
 	DSOUND_MixToTemporary(dsb, frames);
-	ibuf = dsb->device->tmp_buffer;
 
-	if (secondarybuffer_is_audible(dsb)) {
+	dsb->mix_audible = secondarybuffer_is_audible(dsb);
+	if (dsb->mix_audible) {
 		/* Apply volume if needed */
 		DSOUND_MixerVol(dsb, frames);
 
-		mixieee32(ibuf, mix_buffer, frames * dsb->device->pwfx->nChannels);
+		if (mix_buffer)
+			mixieee32(dsb->tmp_buffer, mix_buffer, frames * dsb->device->pwfx->nChannels);
 	}
 
-	/* check for notification positions */
-	if (dsb->dsbd.dwFlags & DSBCAPS_CTRLPOSITIONNOTIFY &&
-	    dsb->state != STATE_STARTING) {
-		INT ilen = DSOUND_BufPtrDiff(dsb->buflen, dsb->sec_mixpos, oldpos);
-		DSOUND_CheckEvent(dsb, oldpos, ilen);
+	/* check for notification positions, the mixer thread does it for rendered buffers */
+	dsb->mix_notify = dsb->dsbd.dwFlags & DSBCAPS_CTRLPOSITIONNOTIFY &&
+	    dsb->state != STATE_STARTING;
+	if (dsb->mix_notify) {
+		dsb->mix_notify_pos = oldpos;
+		dsb->mix_notify_len = DSOUND_BufPtrDiff(dsb->buflen, dsb->sec_mixpos, oldpos);
+		if (mix_buffer)
+			DSOUND_CheckEvent(dsb, oldpos, dsb->mix_notify_len);
 	}
 
 	return frames;
@@ -602,6 +623,105 @@ static DWORD DSOUND_MixOne(IDirectSoundBufferImpl *dsb, float *mix_buffer, DWORD
 	return primary_done;
 }
 
+/**
+ * Mix a secondary buffer into the device buffer if it is still playing, or
+ * only render it into its tmp_buffer if mix_buffer is NULL.
+ *
+ * Returns: TRUE if the buffer was playing.
+ */
+static BOOL DSOUND_MixBuffer(IDirectSoundBufferImpl *dsb, float *mix_buffer, DWORD frames)
+{
+	BOOL playing = FALSE;
+
+	TRACE("Checking %p, frames=%d\n", dsb, frames);
+	AcquireSRWLockShared(&dsb->lock);
+	if (dsb->state != STATE_STOPPED) {
+
+		/* if the buffer was starting, it must be playing now */
+		if (dsb->state == STATE_STARTING)
+			dsb->state = STATE_PLAYING;
+
+		DSOUND_MixOne(dsb, mix_buffer, frames);
+		playing = TRUE;
+	}
+	ReleaseSRWLockShared(&dsb->lock);
+
+	return playing;
+}
+
+/**
+ * Sum a buffer rendered on the thread pool into the device buffer, and
+ * signal the notifications it passed.
+ */
+static void DSOUND_MixRendered(IDirectSoundBufferImpl *dsb, float *mix_buffer, DWORD frames)
+{
+	AcquireSRWLockShared(&dsb->lock);
+	if (dsb->mix_audible)
+		mixieee32(dsb->tmp_buffer, mix_buffer, frames * dsb->device->pwfx->nChannels);
+	if (dsb->mix_notify)
+		DSOUND_CheckEvent(dsb, dsb->mix_notify_pos, dsb->mix_notify_len);
+	ReleaseSRWLockShared(&dsb->lock);
+}
+
+static void CALLBACK DSOUND_mix_work(TP_CALLBACK_INSTANCE *instance, void *context, TP_WORK *work)
+{
+	DirectSoundDevice *device = context;
+	IDirectSoundBufferImpl *dsb;
+	LONG i;
+
+	while ((i = InterlockedIncrement(&device->mix_next) - 1) < device->mix_count) {
+		dsb = device->mix_buffers[i];
+
+		/* DMO effects are not necessarily thread safe, leave them to the mixer thread */
+		if (!dsb->num_filters)
+			dsb->mix_rendered = DSOUND_MixBuffer(dsb, NULL, device->mix_frames);
+	}
+}
+
+/**
+ * Render the secondary buffers in device->mix_buffers on the thread pool.
+ * The results are left in each buffer's tmp_buffer, so that they can be
+ * summed in order and the output matches serial mixing.
+ *
+ * Returns: TRUE if the buffers were rendered.
+ */
+static BOOL DSOUND_RenderParallel(DirectSoundDevice *device, DWORD frames)
+{
+	DWORD i, workers;
+
+	if (!ds_parallel_mix_buffers || device->mix_count < ds_parallel_mix_buffers)
+		return FALSE;
+
+	if (!device->mix_work) {
+		SYSTEM_INFO info;
+
+		GetSystemInfo(&info);
+		if (info.dwNumberOfProcessors < 2)
+			return FALSE;
+		if (!(device->mix_work = CreateThreadpoolWork(DSOUND_mix_work, device, NULL))) {
+			WARN("Failed to create mixer thread pool work, error %u.\n", GetLastError());
+			return FALSE;
+		}
+		device->mix_workers = info.dwNumberOfProcessors - 1;
+		TRACE("Mixing with up to %u worker threads.\n", device->mix_workers);
+	}
+
+	for (i = 0; i < device->mix_count; i++)
+		device->mix_buffers[i]->mix_rendered = FALSE;
+	device->mix_frames = frames;
+	device->mix_next = 0;
+
+	workers = min(device->mix_workers, device->mix_count - 1);
+	for (i = 0; i < workers; i++)
+		SubmitThreadpoolWork(device->mix_work);
+
+	/* help out, and cancel the work items which didn't get to start */
+	DSOUND_mix_work(NULL, device, NULL);
+	WaitForThreadpoolWorkCallbacks(device->mix_work, TRUE);
+
+	return TRUE;
+}
+
 /**
  * For a DirectSoundDevice, go through all the currently playing buffers and
  * mix them in to the device buffer.
@@ -612,36 +732,58 @@ static DWORD DSOUND_MixOne(IDirectSoundBufferImpl *dsb, float *mix_buffer, DWORD
  * Returns:  the length beyond the writepos that was mixed to.
  */
 
-static void DSOUND_MixToPrimary(const DirectSoundDevice *device, float *mix_buffer, DWORD frames, BOOL *all_stopped)
+static void DSOUND_MixToPrimary(DirectSoundDevice *device, float *mix_buffer, DWORD frames, BOOL *all_stopped)
 {
 	INT i;
 	IDirectSoundBufferImpl	*dsb;
+	BOOL rendered;
 
 	/* unless we find a running buffer, all have stopped */
 	*all_stopped = TRUE;
 
 	TRACE("(frames %d)\n", frames);
+
+	if (device->mix_buffers_size < device->nrofbuffers) {
+		IDirectSoundBufferImpl **buffers;
+
+		if (device->mix_buffers)
+			buffers = HeapReAlloc(GetProcessHeap(), 0, device->mix_buffers, device->nrofbuffers * sizeof(*buffers));
+		else
+			buffers = HeapAlloc(GetProcessHeap(), 0, device->nrofbuffers * sizeof(*buffers));
+		if (!buffers) {
+			ERR("Out of memory\n");
+			return;
+		}
+		device->mix_buffers = buffers;
+		device->mix_buffers_size = device->nrofbuffers;
+	}
+
+	/* collect the buffers which may be playing, each one is locked while it is mixed */
+	device->mix_count = 0;
 	for (i = 0; i < device->nrofbuffers; i++) {
 		dsb = device->buffers[i];
 
 		TRACE("MixToPrimary for %p, state=%d\n", dsb, dsb->state);
 
-		if (dsb->buflen && dsb->state) {
-			TRACE("Checking %p, frames=%d\n", dsb, frames);
-			AcquireSRWLockShared(&dsb->lock);
-			if (dsb->state != STATE_STOPPED) {
+		if (dsb->buflen && dsb->state)
+			device->mix_buffers[device->mix_count++] = dsb;
+	}
+
+	if (!device->mix_count)
+		return;
 
-				/* if the buffer was starting, it must be playing now */
-				if (dsb->state == STATE_STARTING)
-					dsb->state = STATE_PLAYING;
+	rendered = DSOUND_RenderParallel(device, frames);
 
-				/* mix next buffer into the main buffer */
-				DSOUND_MixOne(dsb, mix_buffer, frames);
+	for (i = 0; i < device->mix_count; i++) {
+		dsb = device->mix_buffers[i];
 
-				*all_stopped = FALSE;
-			}
-			ReleaseSRWLockShared(&dsb->lock);
+		/* mix next buffer into the main buffer */
+		if (rendered && dsb->mix_rendered) {
+			DSOUND_MixRendered(dsb, mix_buffer, frames);
+			*all_stopped = FALSE;
 		}
+		else if ((!rendered || dsb->num_filters) && DSOUND_MixBuffer(dsb, mix_buffer, frames))
+			*all_stopped = FALSE;
 	}
 }
 
@@ -688,8 +830,8 @@ static void DSOUND_WaveQueue(DirectSoundDevice *device, LPBYTE pos, DWORD bytes)
  * The mixing procedure goes:
  *
  * secondary->buffer (secondary format)
- *   =[Resample]=> device->tmp_buffer (float format)
- *   =[Volume]=> device->tmp_buffer (float format)
+ *   =[Resample]=> secondary->tmp_buffer (float format)
+ *   =[Volume]=> secondary->tmp_buffer (float format)
  *   =[Reformat]=> device->buffer (device format, skipped on float)
  */
 static void DSOUND_PerformMix(DirectSoundDevice *device)
@@ -281,6 +281,7 @@ struct dwrite_fontface
     IDWriteLocalizedStrings *names;
 
     struct scriptshaping_cache *shaping_cache;
+    struct layout_shaping_cache *layout_shaping_cache;
 
     LOGFONTW lf;
 };
@@ -352,6 +353,9 @@ struct dwrite_fontface;
 extern float fontface_get_scaled_design_advance(struct dwrite_fontface *fontface, DWRITE_MEASURING_MODE measuring_mode,
         float emsize, float ppdip, const DWRITE_MATRIX *transform, UINT16 glyph, BOOL is_sideways) DECLSPEC_HIDDEN;
 extern struct dwrite_fontface *unsafe_impl_from_IDWriteFontFace(IDWriteFontFace *iface) DECLSPEC_HIDDEN;
+extern struct layout_shaping_cache *fontface_get_layout_shaping_cache(IDWriteFontFace *fontface) DECLSPEC_HIDDEN;
+extern HRESULT create_layout_shaping_cache(struct layout_shaping_cache **cache) DECLSPEC_HIDDEN;
+extern void release_layout_shaping_cache(struct layout_shaping_cache *cache) DECLSPEC_HIDDEN;
 
 /* Opentype font table functions */
 struct dwrite_font_props
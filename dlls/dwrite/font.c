@@ -843,6 +843,7 @@ static ULONG WINAPI dwritefontface_Release(IDWriteFontFace5 *iface)
             free(fontface->cached);
         }
         release_scriptshaping_cache(fontface->shaping_cache);
+        release_layout_shaping_cache(fontface->layout_shaping_cache);
         if (fontface->vdmx.context)
             IDWriteFontFace5_ReleaseFontTable(iface, fontface->vdmx.context);
         if (fontface->gasp.context)
@@ -2526,6 +2527,20 @@ struct dwrite_fontface *unsafe_impl_from_IDWriteFontFace(IDWriteFontFace *iface)
     return CONTAINING_RECORD(iface, struct dwrite_fontface, IDWriteFontFace5_iface);
 }
 
+struct layout_shaping_cache *fontface_get_layout_shaping_cache(IDWriteFontFace *iface)
+{
+    struct dwrite_fontface *fontface = unsafe_impl_from_IDWriteFontFace(iface);
+    struct layout_shaping_cache *cache;
+
+    if (!fontface->layout_shaping_cache && SUCCEEDED(create_layout_shaping_cache(&cache)))
+    {
+        if (InterlockedCompareExchangePointer((void **)&fontface->layout_shaping_cache, cache, NULL))
+            release_layout_shaping_cache(cache);
+    }
+
+    return fontface->layout_shaping_cache;
+}
+
 static struct dwrite_fontfacereference *unsafe_impl_from_IDWriteFontFaceReference(IDWriteFontFaceReference *iface)
 {
     if (!iface)
@@ -4625,6 +4640,362 @@ static void fontcollection_add_replacements(struct dwrite_fontcollection *collec
     RegCloseKey(hkey);
 }
 
+static HRESULT fontcollection_add_font_data(struct dwrite_fontcollection *collection,
+        struct dwrite_font_data *font_data)
+{
+    WCHAR familyW[255];
+    UINT32 index;
+    HRESULT hr;
+
+    fontstrings_get_en_string(font_data->family_names, familyW, ARRAY_SIZE(familyW));
+
+    /* ignore dot named faces */
+    if (familyW[0] == '.')
+    {
+        WARN("Ignoring face %s\n", debugstr_w(familyW));
+        release_font_data(font_data);
+        return S_OK;
+    }
+
+    index = collection_find_family(collection, familyW);
+    if (index != ~0u)
+        hr = fontfamily_add_font(collection->family_data[index], font_data);
+    else {
+        struct dwrite_fontfamily_data *family_data;
+
+        /* create and init new family */
+        hr = init_fontfamily_data(font_data->family_names, &family_data);
+        if (hr == S_OK) {
+            /* add font to family, family - to collection */
+            hr = fontfamily_add_font(family_data, font_data);
+            if (hr == S_OK)
+                hr = fontcollection_add_family(collection, family_data);
+
+            if (FAILED(hr))
+                release_fontfamily_data(family_data);
+        }
+    }
+
+    if (FAILED(hr))
+        release_font_data(font_data);
+
+    return hr;
+}
+
+/* Per-face metadata of the system collection is cached in a volatile key, shared by
+   all processes of the session. Entries are keyed by file path and validated with
+   the last write time of the file. */
+#define FONT_CACHE_VERSION 2
+
+struct font_cache_file
+{
+    DWORD version;
+    FILETIME writetime;
+    DWRITE_FONT_FACE_TYPE face_type;
+    UINT32 face_count;
+    /* followed by face_count font_cache_face records */
+};
+
+struct font_cache_face
+{
+    DWORD size; /* record size, including strings */
+    DWORD valid;
+    DWRITE_FONT_STYLE style;
+    DWRITE_FONT_STRETCH stretch;
+    DWRITE_FONT_WEIGHT weight;
+    DWRITE_PANOSE panose;
+    FONTSIGNATURE fontsig;
+    UINT32 flags;
+    DWRITE_FONT_AXIS_VALUE axis[3];
+    DWRITE_FONT_METRICS1 metrics;
+    LOGFONTW lf;
+    /* followed by family and face names, each stored as a DWORD string count
+       and pairs of null-terminated locale and string values */
+};
+
+struct font_cache_entry
+{
+    WCHAR *path;
+    FILETIME writetime;
+    BYTE *data;
+    size_t size;
+    size_t capacity;
+};
+
+static HKEY open_font_cache_key(void)
+{
+    HKEY hkey;
+
+    if (RegCreateKeyExW(HKEY_CURRENT_USER, L"Software\\Wine\\DirectWrite\\FontCache", 0, NULL,
+            REG_OPTION_VOLATILE, KEY_ALL_ACCESS, NULL, &hkey, NULL))
+        return NULL;
+
+    return hkey;
+}
+
+static BOOL font_cache_get_file_info(IDWriteFontFile *file, struct font_cache_entry *entry)
+{
+    IDWriteLocalFontFileLoader *local_loader;
+    IDWriteFontFileLoader *loader;
+    UINT32 key_size, length;
+    const void *key;
+    BOOL ret = FALSE;
+
+    if (FAILED(IDWriteFontFile_GetLoader(file, &loader)))
+        return FALSE;
+
+    if (SUCCEEDED(IDWriteFontFileLoader_QueryInterface(loader, &IID_IDWriteLocalFontFileLoader, (void **)&local_loader)))
+    {
+        if (SUCCEEDED(IDWriteFontFile_GetReferenceKey(file, &key, &key_size)) &&
+                SUCCEEDED(IDWriteLocalFontFileLoader_GetFilePathLengthFromKey(local_loader, key, key_size, &length)) &&
+                SUCCEEDED(IDWriteLocalFontFileLoader_GetLastWriteTimeFromKey(local_loader, key, key_size, &entry->writetime)) &&
+                (entry->path = malloc((length + 1) * sizeof(WCHAR))))
+        {
+            if (SUCCEEDED(IDWriteLocalFontFileLoader_GetFilePathFromKey(local_loader, key, key_size, entry->path, length + 1)))
+                ret = TRUE;
+            else
+            {
+                free(entry->path);
+                entry->path = NULL;
+            }
+        }
+        IDWriteLocalFontFileLoader_Release(local_loader);
+    }
+    IDWriteFontFileLoader_Release(loader);
+
+    return ret;
+}
+
+static BOOL font_cache_write(struct font_cache_entry *entry, const void *data, size_t size)
+{
+    if (!dwrite_array_reserve((void **)&entry->data, &entry->capacity, entry->size + size, 1))
+        return FALSE;
+    memcpy(entry->data + entry->size, data, size);
+    entry->size += size;
+    return TRUE;
+}
+
+static BOOL font_cache_write_strings(struct font_cache_entry *entry, IDWriteLocalizedStrings *strings)
+{
+    DWORD i, count = IDWriteLocalizedStrings_GetCount(strings);
+    WCHAR buffer[256];
+    UINT32 length;
+
+    if (!font_cache_write(entry, &count, sizeof(count)))
+        return FALSE;
+
+    for (i = 0; i < count; ++i)
+    {
+        if (FAILED(IDWriteLocalizedStrings_GetLocaleName(strings, i, buffer, ARRAY_SIZE(buffer))) ||
+                !font_cache_write(entry, buffer, (wcslen(buffer) + 1) * sizeof(WCHAR)))
+            return FALSE;
+
+        if (FAILED(IDWriteLocalizedStrings_GetStringLength(strings, i, &length)) || length >= ARRAY_SIZE(buffer) ||
+                FAILED(IDWriteLocalizedStrings_GetString(strings, i, buffer, ARRAY_SIZE(buffer))) ||
+                !font_cache_write(entry, buffer, (length + 1) * sizeof(WCHAR)))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+static BOOL font_cache_add_face(struct font_cache_entry *entry, const struct dwrite_font_data *data)
+{
+    static const WCHAR padding;
+    struct font_cache_face face;
+    size_t offset = entry->size;
+
+    memset(&face, 0, sizeof(face));
+    if (data)
+    {
+        face.valid = 1;
+        face.style = data->style;
+        face.stretch = data->stretch;
+        face.weight = data->weight;
+        face.panose = data->panose;
+        face.fontsig = data->fontsig;
+        face.flags = data->flags;
+        memcpy(face.axis, data->axis, sizeof(face.axis));
+        face.metrics = data->metrics;
+        face.lf = data->lf;
+    }
+
+    if (!font_cache_write(entry, &face, sizeof(face)))
+        return FALSE;
+
+    if (data)
+    {
+        if (!font_cache_write_strings(entry, data->family_names) ||
+                !font_cache_write_strings(entry, data->names))
+            return FALSE;
+
+        /* Keep records DWORD aligned. */
+        if (entry->size % sizeof(DWORD) && !font_cache_write(entry, &padding, sizeof(padding)))
+            return FALSE;
+    }
+
+    ((struct font_cache_face *)(entry->data + offset))->size = entry->size - offset;
+    return TRUE;
+}
+
+static BOOL font_cache_init_entry(struct font_cache_entry *entry, DWRITE_FONT_FACE_TYPE face_type, UINT32 face_count)
+{
+    struct font_cache_file header;
+
+    header.version = FONT_CACHE_VERSION;
+    header.writetime = entry->writetime;
+    header.face_type = face_type;
+    header.face_count = face_count;
+
+    entry->size = 0;
+    return font_cache_write(entry, &header, sizeof(header));
+}
+
+static void font_cache_store_entry(HKEY cache_key, const struct font_cache_entry *entry)
+{
+    RegSetValueExW(cache_key, entry->path, 0, REG_BINARY, entry->data, entry->size);
+}
+
+static const WCHAR *font_cache_skip_string(const WCHAR *ptr, const WCHAR *end)
+{
+    while (ptr < end && *ptr) ptr++;
+    return ptr < end ? ptr + 1 : NULL;
+}
+
+static const WCHAR *font_cache_read_strings(const WCHAR *ptr, const WCHAR *end, IDWriteLocalizedStrings **ret)
+{
+    IDWriteLocalizedStrings *strings;
+    const WCHAR *locale, *str;
+    DWORD i, count;
+
+    *ret = NULL;
+
+    /* the count follows variable length strings, so it may be unaligned */
+    if ((const BYTE *)end - (const BYTE *)ptr < sizeof(count))
+        return NULL;
+    memcpy(&count, ptr, sizeof(count));
+    ptr += sizeof(count) / sizeof(*ptr);
+
+    if (FAILED(create_localizedstrings(&strings)))
+        return NULL;
+    for (i = 0; i < count; ++i)
+    {
+        locale = ptr;
+        if (!(ptr = font_cache_skip_string(ptr, end))) break;
+        str = ptr;
+        if (!(ptr = font_cache_skip_string(ptr, end))) break;
+        if (FAILED(add_localizedstring(strings, locale, str))) break;
+    }
+
+    if (i < count)
+    {
+        IDWriteLocalizedStrings_Release(strings);
+        return NULL;
+    }
+
+    *ret = strings;
+    return ptr;
+}
+
+static HRESULT init_font_data_from_cache(const struct font_cache_face *face, IDWriteFontFile *file,
+        DWRITE_FONT_FACE_TYPE face_type, UINT32 index, struct dwrite_font_data **ret)
+{
+    const WCHAR *ptr = (const WCHAR *)(face + 1), *end = (const WCHAR *)((const BYTE *)face + face->size);
+    struct dwrite_font_data *data;
+
+    *ret = NULL;
+
+    if (!(data = calloc(1, sizeof(*data))))
+        return E_OUTOFMEMORY;
+
+    data->refcount = 1;
+    data->file = file;
+    data->face_index = index;
+    data->face_type = face_type;
+    IDWriteFontFile_AddRef(data->file);
+
+    if (!(ptr = font_cache_read_strings(ptr, end, &data->family_names)) ||
+            !font_cache_read_strings(ptr, end, &data->names))
+    {
+        release_font_data(data);
+        return E_FAIL;
+    }
+
+    data->style = face->style;
+    data->stretch = face->stretch;
+    data->weight = face->weight;
+    data->panose = face->panose;
+    data->fontsig = face->fontsig;
+    data->flags = face->flags;
+    memcpy(data->axis, face->axis, sizeof(data->axis));
+    data->metrics = face->metrics;
+    data->lf = face->lf;
+
+    init_font_prop_vec(data->weight, data->stretch, data->style, &data->propvec);
+
+    *ret = data;
+    return S_OK;
+}
+
+/* Returns TRUE if cached data for the whole file was found and its faces were added. */
+static BOOL fontcollection_add_cached_file(struct dwrite_fontcollection *collection, HKEY cache_key,
+        const struct font_cache_entry *entry, IDWriteFontFile *file, HRESULT *hr)
+{
+    const struct font_cache_file *header;
+    const struct font_cache_face *face;
+    DWORD type, size = 0;
+    const BYTE *end;
+    BYTE *buffer;
+    UINT32 i;
+
+    if (RegQueryValueExW(cache_key, entry->path, NULL, &type, NULL, &size) || type != REG_BINARY ||
+            size < sizeof(*header))
+        return FALSE;
+
+    if (!(buffer = malloc(size)))
+        return FALSE;
+
+    if (RegQueryValueExW(cache_key, entry->path, NULL, NULL, buffer, &size))
+    {
+        free(buffer);
+        return FALSE;
+    }
+
+    header = (const struct font_cache_file *)buffer;
+    end = buffer + size;
+    if (header->version != FONT_CACHE_VERSION || CompareFileTime(&header->writetime, &entry->writetime))
+    {
+        free(buffer);
+        return FALSE;
+    }
+
+    /* Validate all records before adding anything. */
+    face = (const struct font_cache_face *)(header + 1);
+    for (i = 0; i < header->face_count; ++i)
+    {
+        if ((const BYTE *)face + sizeof(*face) > end || face->size < sizeof(*face) ||
+                face->size > (size_t)(end - (const BYTE *)face))
+        {
+            free(buffer);
+            return FALSE;
+        }
+        face = (const struct font_cache_face *)((const BYTE *)face + face->size);
+    }
+
+    face = (const struct font_cache_face *)(header + 1);
+    for (i = 0; i < header->face_count && *hr == S_OK; ++i)
+    {
+        struct dwrite_font_data *font_data;
+
+        if (face->valid && init_font_data_from_cache(face, file, header->face_type, i, &font_data) == S_OK)
+            *hr = fontcollection_add_font_data(collection, font_data);
+        face = (const struct font_cache_face *)((const BYTE *)face + face->size);
+    }
+
+    free(buffer);
+    return TRUE;
+}
+
 HRESULT create_font_collection(IDWriteFactory7 *factory, IDWriteFontFileEnumerator *enumerator, BOOL is_system,
     IDWriteFontCollection3 **ret)
 {
@@ -4633,8 +5004,10 @@ HRESULT create_font_collection(IDWriteFactory7 *factory, IDWriteFontFileEnumerat
         IDWriteFontFile *file;
     };
     struct fontfile_enum *fileenum, *fileenum2;
+    struct font_cache_entry cache_entry = { 0 };
     struct dwrite_fontcollection *collection;
     struct list scannedfiles;
+    HKEY cache_key = NULL;
     BOOL current = FALSE;
     HRESULT hr = S_OK;
     size_t i;
@@ -4655,11 +5028,14 @@ HRESULT create_font_collection(IDWriteFactory7 *factory, IDWriteFontFileEnumerat
 
     TRACE("building font collection:\n");
 
+    if (is_system)
+        cache_key = open_font_cache_key();
+
     list_init(&scannedfiles);
     while (hr == S_OK) {
         DWRITE_FONT_FACE_TYPE face_type;
         DWRITE_FONT_FILE_TYPE file_type;
-        BOOL supported, same = FALSE;
+        BOOL supported, same = FALSE, cache;
         IDWriteFontFileStream *stream;
         IDWriteFontFile *file;
         UINT32 face_count;
@@ -4684,6 +5060,17 @@ HRESULT create_font_collection(IDWriteFactory7 *factory, IDWriteFontFileEnumerat
             continue;
         }
 
+        free(cache_entry.path);
+        cache_entry.path = NULL;
+        if (cache_key && font_cache_get_file_info(file, &cache_entry) &&
+                fontcollection_add_cached_file(collection, cache_key, &cache_entry, file, &hr))
+        {
+            fileenum = malloc(sizeof(*fileenum));
+            fileenum->file = file;
+            list_add_tail(&scannedfiles, &fileenum->entry);
+            continue;
+        }
+
         if (FAILED(get_filestream_from_file(file, &stream))) {
             IDWriteFontFile_Release(file);
             continue;
@@ -4693,6 +5080,8 @@ HRESULT create_font_collection(IDWriteFactory7 *factory, IDWriteFontFileEnumerat
         hr = opentype_analyze_font(stream, &supported, &file_type, &face_type, &face_count);
         if (FAILED(hr) || !supported || face_count == 0) {
             TRACE("Unsupported font (%p, 0x%08x, %d, %u)\n", file, hr, supported, face_count);
+            if (SUCCEEDED(hr) && cache_entry.path && font_cache_init_entry(&cache_entry, face_type, 0))
+                font_cache_store_entry(cache_key, &cache_entry);
             IDWriteFontFileStream_Release(stream);
             IDWriteFontFile_Release(file);
             hr = S_OK;
@@ -4704,12 +5093,12 @@ HRESULT create_font_collection(IDWriteFactory7 *factory, IDWriteFontFileEnumerat
         fileenum->file = file;
         list_add_tail(&scannedfiles, &fileenum->entry);
 
+        cache = cache_entry.path && font_cache_init_entry(&cache_entry, face_type, face_count);
+
         for (i = 0; i < face_count; ++i)
         {
             struct dwrite_font_data *font_data;
             struct fontface_desc desc;
-            WCHAR familyW[255];
-            UINT32 index;
 
             desc.factory = factory;
             desc.face_type = face_type;
@@ -4723,50 +5112,31 @@ HRESULT create_font_collection(IDWriteFactory7 *factory, IDWriteFontFileEnumerat
             hr = init_font_data(&desc, &font_data);
             if (FAILED(hr))
             {
+                if (cache)
+                    cache = font_cache_add_face(&cache_entry, NULL);
                 /* move to next one */
                 hr = S_OK;
                 continue;
             }
 
-            fontstrings_get_en_string(font_data->family_names, familyW, ARRAY_SIZE(familyW));
-
-            /* ignore dot named faces */
-            if (familyW[0] == '.')
-            {
-                WARN("Ignoring face %s\n", debugstr_w(familyW));
-                release_font_data(font_data);
-                continue;
-            }
-
-            index = collection_find_family(collection, familyW);
-            if (index != ~0u)
-                hr = fontfamily_add_font(collection->family_data[index], font_data);
-            else {
-                struct dwrite_fontfamily_data *family_data;
-
-                /* create and init new family */
-                hr = init_fontfamily_data(font_data->family_names, &family_data);
-                if (hr == S_OK) {
-                    /* add font to family, family - to collection */
-                    hr = fontfamily_add_font(family_data, font_data);
-                    if (hr == S_OK)
-                        hr = fontcollection_add_family(collection, family_data);
+            if (cache)
+                cache = font_cache_add_face(&cache_entry, font_data);
 
-                    if (FAILED(hr))
-                        release_fontfamily_data(family_data);
-                }
-            }
-
-            if (FAILED(hr))
-            {
-                release_font_data(font_data);
+            if (FAILED(hr = fontcollection_add_font_data(collection, font_data)))
                 break;
-            }
         }
 
+        if (cache && hr == S_OK)
+            font_cache_store_entry(cache_key, &cache_entry);
+
         IDWriteFontFileStream_Release(stream);
     }
 
+    free(cache_entry.path);
+    free(cache_entry.data);
+    if (cache_key)
+        RegCloseKey(cache_key);
+
     LIST_FOR_EACH_ENTRY_SAFE(fileenum, fileenum2, &scannedfiles, struct fontfile_enum, entry)
     {
         IDWriteFontFile_Release(fileenum->file);
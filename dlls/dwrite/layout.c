@@ -1134,7 +1134,6 @@ static HRESULT layout_shape_get_glyphs(struct dwrite_textlayout *layout, struct
     unsigned int max_count;
     HRESULT hr;
 
-    run->descr.localeName = get_layout_range_by_pos(layout, run->descr.textPosition)->locale;
     run->clustermap = calloc(run->descr.stringLength, sizeof(*run->clustermap));
     if (!run->clustermap)
         return E_OUTOFMEMORY;
@@ -1298,25 +1297,283 @@ static HRESULT layout_shape_get_positions(struct dwrite_textlayout *layout, stru
         WARN("%s: failed to get glyph placement info, hr %#x.\n", debugstr_rundescr(&run->descr), hr);
     }
 
-    if (SUCCEEDED(hr))
-        hr = layout_shape_apply_character_spacing(layout, context);
-
     run->run.glyphAdvances = run->advances;
     run->run.glyphOffsets = run->offsets;
 
     return hr;
 }
 
+/* Shaping results of short runs are cached per font face, so that layouts created
+   repeatedly for the same text reuse glyphs and placements. Font faces are shared
+   by all layouts of a factory. */
+#define SHAPING_CACHE_MAX_ENTRIES 128
+#define SHAPING_CACHE_MAX_LENGTH 256
+
+struct layout_shaping_cache_entry
+{
+    struct list entry;
+
+    /* Key */
+    UINT32 hash;
+    FLOAT emsize;
+    BOOL is_sideways;
+    BOOL is_rtl;
+    DWRITE_SCRIPT_ANALYSIS sa;
+    WCHAR locale[LOCALE_NAME_MAX_LENGTH];
+    WCHAR *text;
+    UINT32 length;
+
+    /* Shaping output */
+    UINT32 glyph_count;
+    UINT16 *glyphs;
+    UINT16 *clustermap;
+    FLOAT *advances;
+    DWRITE_GLYPH_OFFSET *offsets;
+    DWRITE_SHAPING_GLYPH_PROPERTIES *glyph_props;
+};
+
+struct layout_shaping_cache
+{
+    CRITICAL_SECTION cs;
+    struct list entries; /* most recently used first */
+    unsigned int count;
+    unsigned int hits;
+    unsigned int misses;
+};
+
+HRESULT create_layout_shaping_cache(struct layout_shaping_cache **ret)
+{
+    struct layout_shaping_cache *cache;
+
+    if (!(cache = calloc(1, sizeof(*cache))))
+        return E_OUTOFMEMORY;
+
+    list_init(&cache->entries);
+    InitializeCriticalSection(&cache->cs);
+    cache->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": layout_shaping_cache.cs");
+
+    *ret = cache;
+    return S_OK;
+}
+
+static void release_shaping_cache_entry(struct layout_shaping_cache_entry *entry)
+{
+    free(entry->text);
+    free(entry->glyphs);
+    free(entry->clustermap);
+    free(entry->advances);
+    free(entry->offsets);
+    free(entry->glyph_props);
+    free(entry);
+}
+
+void release_layout_shaping_cache(struct layout_shaping_cache *cache)
+{
+    struct layout_shaping_cache_entry *entry, *entry2;
+
+    if (!cache)
+        return;
+
+    TRACE("%p: %u hits, %u misses.\n", cache, cache->hits, cache->misses);
+
+    LIST_FOR_EACH_ENTRY_SAFE(entry, entry2, &cache->entries, struct layout_shaping_cache_entry, entry)
+        release_shaping_cache_entry(entry);
+
+    cache->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection(&cache->cs);
+    free(cache);
+}
+
+static UINT32 shaping_cache_hash(const struct regular_layout_run *run)
+{
+    UINT32 hash = 2166136261u, i;
+
+    for (i = 0; i < run->descr.stringLength; ++i)
+        hash = (hash ^ run->descr.string[i]) * 16777619u;
+    hash = (hash ^ *(const UINT32 *)&run->run.fontEmSize) * 16777619u;
+
+    return hash;
+}
+
+static BOOL shaping_cache_entry_matches(const struct layout_shaping_cache_entry *entry, const struct regular_layout_run *run,
+        UINT32 hash)
+{
+    return entry->hash == hash &&
+            entry->emsize == run->run.fontEmSize &&
+            entry->is_sideways == !!run->run.isSideways &&
+            entry->is_rtl == (run->run.bidiLevel & 1) &&
+            entry->sa.script == run->sa.script &&
+            entry->sa.shapes == run->sa.shapes &&
+            entry->length == run->descr.stringLength &&
+            !memcmp(entry->text, run->descr.string, entry->length * sizeof(WCHAR)) &&
+            !wcscmp(entry->locale, run->descr.localeName);
+}
+
+static void *shaping_cache_dup(const void *data, size_t size)
+{
+    void *ret;
+
+    if ((ret = malloc(size)))
+        memcpy(ret, data, size);
+    return ret;
+}
+
+/* Fills run arrays from a cached entry, returns FALSE if the run is not in the cache. */
+static BOOL shaping_cache_get(struct layout_shaping_cache *cache, struct regular_layout_run *run,
+        struct shaping_context *context)
+{
+    struct layout_shaping_cache_entry *entry;
+    UINT32 hash = shaping_cache_hash(run);
+    BOOL found = FALSE;
+
+    EnterCriticalSection(&cache->cs);
+
+    LIST_FOR_EACH_ENTRY(entry, &cache->entries, struct layout_shaping_cache_entry, entry)
+    {
+        if (!shaping_cache_entry_matches(entry, run, hash)) continue;
+
+        run->glyphcount = entry->glyph_count;
+        run->glyphs = shaping_cache_dup(entry->glyphs, entry->glyph_count * sizeof(*entry->glyphs));
+        run->clustermap = shaping_cache_dup(entry->clustermap, entry->length * sizeof(*entry->clustermap));
+        run->advances = shaping_cache_dup(entry->advances, entry->glyph_count * sizeof(*entry->advances));
+        run->offsets = shaping_cache_dup(entry->offsets, entry->glyph_count * sizeof(*entry->offsets));
+        context->glyph_props = shaping_cache_dup(entry->glyph_props, entry->glyph_count * sizeof(*entry->glyph_props));
+
+        if (run->glyphs && run->clustermap && run->advances && run->offsets && context->glyph_props)
+        {
+            list_remove(&entry->entry);
+            list_add_head(&cache->entries, &entry->entry);
+            found = TRUE;
+        }
+        else
+        {
+            free(run->glyphs);
+            free(run->clustermap);
+            free(run->advances);
+            free(run->offsets);
+            free(context->glyph_props);
+            run->glyphs = run->clustermap = NULL;
+            run->advances = NULL;
+            run->offsets = NULL;
+            context->glyph_props = NULL;
+        }
+        break;
+    }
+
+    if (found)
+        cache->hits++;
+    else
+        cache->misses++;
+
+    LeaveCriticalSection(&cache->cs);
+
+    if (found)
+    {
+        run->run.glyphIndices = run->glyphs;
+        run->descr.clusterMap = run->clustermap;
+        run->run.glyphAdvances = run->advances;
+        run->run.glyphOffsets = run->offsets;
+    }
+
+    return found;
+}
+
+static void shaping_cache_put(struct layout_shaping_cache *cache, const struct regular_layout_run *run,
+        const struct shaping_context *context)
+{
+    struct layout_shaping_cache_entry *entry;
+
+    if (!(entry = calloc(1, sizeof(*entry))))
+        return;
+
+    entry->hash = shaping_cache_hash(run);
+    entry->emsize = run->run.fontEmSize;
+    entry->is_sideways = !!run->run.isSideways;
+    entry->is_rtl = run->run.bidiLevel & 1;
+    entry->sa = run->sa;
+    lstrcpynW(entry->locale, run->descr.localeName, ARRAY_SIZE(entry->locale));
+    entry->length = run->descr.stringLength;
+    entry->glyph_count = run->glyphcount;
+    entry->text = shaping_cache_dup(run->descr.string, run->descr.stringLength * sizeof(*run->descr.string));
+    entry->glyphs = shaping_cache_dup(run->glyphs, run->glyphcount * sizeof(*run->glyphs));
+    entry->clustermap = shaping_cache_dup(run->clustermap, run->descr.stringLength * sizeof(*run->clustermap));
+    entry->advances = shaping_cache_dup(run->advances, run->glyphcount * sizeof(*run->advances));
+    entry->offsets = shaping_cache_dup(run->offsets, run->glyphcount * sizeof(*run->offsets));
+    entry->glyph_props = shaping_cache_dup(context->glyph_props, run->glyphcount * sizeof(*context->glyph_props));
+
+    if (!entry->text || !entry->glyphs || !entry->clustermap || !entry->advances || !entry->offsets ||
+            !entry->glyph_props)
+    {
+        release_shaping_cache_entry(entry);
+        return;
+    }
+
+    EnterCriticalSection(&cache->cs);
+
+    list_add_head(&cache->entries, &entry->entry);
+    if (++cache->count > SHAPING_CACHE_MAX_ENTRIES)
+    {
+        entry = LIST_ENTRY(list_tail(&cache->entries), struct layout_shaping_cache_entry, entry);
+        list_remove(&entry->entry);
+        cache->count--;
+    }
+    else
+        entry = NULL;
+
+    LeaveCriticalSection(&cache->cs);
+
+    if (entry)
+        release_shaping_cache_entry(entry);
+}
+
+static BOOL layout_has_user_features(struct dwrite_textlayout *layout)
+{
+    struct layout_range_iface *range;
+
+    LIST_FOR_EACH_ENTRY(range, &layout->typographies, struct layout_range_iface, h.entry)
+    {
+        if (range->iface) return TRUE;
+    }
+
+    return FALSE;
+}
+
+static struct layout_shaping_cache *layout_get_shaping_cache(struct dwrite_textlayout *layout,
+        const struct regular_layout_run *run)
+{
+    /* GDI-compatible placements depend on layout transform, user features on typography ranges. */
+    if (!run->descr.stringLength || run->descr.stringLength > SHAPING_CACHE_MAX_LENGTH ||
+            is_layout_gdi_compatible(layout) || layout_has_user_features(layout))
+        return NULL;
+
+    return fontface_get_layout_shaping_cache(run->run.fontFace);
+}
+
 static HRESULT layout_shape_run(struct dwrite_textlayout *layout, struct regular_layout_run *run)
 {
     struct shaping_context context = { 0 };
+    struct layout_shaping_cache *cache;
     HRESULT hr;
 
     context.analyzer = get_text_analyzer();
     context.run = run;
 
-    if (SUCCEEDED(hr = layout_shape_get_glyphs(layout, &context)))
-        hr = layout_shape_get_positions(layout, &context);
+    run->descr.localeName = get_layout_range_by_pos(layout, run->descr.textPosition)->locale;
+    cache = layout_get_shaping_cache(layout, run);
+
+    if (cache && shaping_cache_get(cache, run, &context))
+        hr = S_OK;
+    else
+    {
+        if (SUCCEEDED(hr = layout_shape_get_glyphs(layout, &context)))
+            hr = layout_shape_get_positions(layout, &context);
+
+        if (hr == S_OK && cache)
+            shaping_cache_put(cache, run, &context);
+    }
+
+    if (SUCCEEDED(hr))
+        hr = layout_shape_apply_character_spacing(layout, &context);
 
     layout_shape_clear_context(&context);
 
@@ -10320,6 +10320,144 @@ if (SUCCEEDED(hr))
     DELETE_FONTFILE(path);
 }
 
+static BOOL system_collection_has_family(const WCHAR *name)
+{
+    IDWriteFontCollection *collection;
+    IDWriteFactory *factory;
+    BOOL exists = FALSE;
+    UINT32 index;
+    HRESULT hr;
+
+    factory = create_factory();
+    hr = IDWriteFactory_GetSystemFontCollection(factory, &collection, FALSE);
+    ok(hr == S_OK, "Failed to get system collection, hr %#x.\n", hr);
+    hr = IDWriteFontCollection_FindFamilyName(collection, name, &index, &exists);
+    ok(hr == S_OK, "Failed to find family, hr %#x.\n", hr);
+    IDWriteFontCollection_Release(collection);
+    IDWriteFactory_Release(factory);
+
+    return exists;
+}
+
+static void set_file_writetime(const WCHAR *path, const FILETIME *writetime, FILETIME *old)
+{
+    HANDLE file;
+    BOOL ret;
+
+    file = CreateFileW(path, GENERIC_READ | FILE_WRITE_ATTRIBUTES, 0, NULL, OPEN_EXISTING, 0, 0);
+    ok(file != INVALID_HANDLE_VALUE, "Failed to open %s, error %u.\n", wine_dbgstr_w(path), GetLastError());
+    if (old)
+    {
+        ret = GetFileTime(file, NULL, NULL, old);
+        ok(ret, "Failed to get file time, error %u.\n", GetLastError());
+    }
+    ret = SetFileTime(file, NULL, NULL, writetime);
+    ok(ret, "Failed to set file time, error %u.\n", GetLastError());
+    CloseHandle(file);
+}
+
+static void test_system_font_cache(void)
+{
+    DWORD size, cached_size, other_size = 0, name_len, i;
+    WCHAR *path, other_path[MAX_PATH];
+    WIN32_FILE_ATTRIBUTE_DATA attrs;
+    BYTE *data, *buffer, *other_data;
+    HKEY fonts_key, cache_key;
+    FILETIME writetime;
+    LSTATUS status;
+
+    /* The system collection was already built by the previous tests. */
+    if (RegOpenKeyExW(HKEY_CURRENT_USER, L"Software\\Wine\\DirectWrite\\FontCache", 0, KEY_ALL_ACCESS, &cache_key))
+    {
+        win_skip("System font cache is not supported.\n");
+        return;
+    }
+
+    if (RegOpenKeyExW(HKEY_LOCAL_MACHINE, L"Software\\Microsoft\\Windows NT\\CurrentVersion\\Fonts", 0,
+            KEY_SET_VALUE, &fonts_key))
+    {
+        skip("Failed to open the system fonts key.\n");
+        RegCloseKey(cache_key);
+        return;
+    }
+
+    path = create_testfontfile(test_fontfile);
+    status = RegSetValueExW(fonts_key, L"wine_test (TrueType)", 0, REG_SZ, (BYTE *)path,
+            (lstrlenW(path) + 1) * sizeof(WCHAR));
+    ok(!status, "Failed to register the test font, status %d.\n", status);
+    ok(system_collection_has_family(L"wine_test"), "Test font wasn't added.\n");
+
+    cached_size = 0;
+    status = RegQueryValueExW(cache_key, path, NULL, NULL, NULL, &cached_size);
+    ok(!status, "Test font wasn't cached, status %d.\n", status);
+    if (status)
+        goto done;
+
+    data = heap_alloc(cached_size);
+    buffer = heap_alloc(cached_size);
+    size = cached_size;
+    status = RegQueryValueExW(cache_key, path, NULL, NULL, data, &size);
+    ok(!status, "Failed to read the cache entry, status %d.\n", status);
+
+    /* A truncated entry is ignored and rebuilt. */
+    RegSetValueExW(cache_key, path, 0, REG_BINARY, data, cached_size / 2);
+    ok(system_collection_has_family(L"wine_test"), "Test font wasn't added.\n");
+    size = cached_size;
+    status = RegQueryValueExW(cache_key, path, NULL, NULL, buffer, &size);
+    ok(!status, "Failed to read the cache entry, status %d.\n", status);
+    ok(size == cached_size && !memcmp(buffer, data, size), "Entry wasn't rebuilt, size %u.\n", size);
+
+    /* So is a corrupted one. */
+    memset(buffer, 0xcc, cached_size);
+    RegSetValueExW(cache_key, path, 0, REG_BINARY, buffer, cached_size);
+    ok(system_collection_has_family(L"wine_test"), "Test font wasn't added.\n");
+    size = cached_size;
+    status = RegQueryValueExW(cache_key, path, NULL, NULL, buffer, &size);
+    ok(!status, "Failed to read the cache entry, status %d.\n", status);
+    ok(size == cached_size && !memcmp(buffer, data, size), "Entry wasn't rebuilt, size %u.\n", size);
+
+    /* Entries are validated with the last write time of the file. Give the test font the entry
+       and write time of another font, the entry is then used as is. */
+    other_data = NULL;
+    for (i = 0; !other_data; ++i)
+    {
+        name_len = ARRAY_SIZE(other_path);
+        status = RegEnumValueW(cache_key, i, other_path, &name_len, NULL, NULL, NULL, &other_size);
+        if (status == ERROR_NO_MORE_ITEMS)
+            break;
+        if (status || !lstrcmpiW(other_path, path) ||
+                !GetFileAttributesExW(other_path, GetFileExInfoStandard, &attrs))
+            continue;
+        other_data = heap_alloc(other_size);
+        status = RegQueryValueExW(cache_key, other_path, NULL, NULL, other_data, &other_size);
+        ok(!status, "Failed to read the cache entry, status %d.\n", status);
+    }
+
+    if (other_data)
+    {
+        set_file_writetime(path, &attrs.ftLastWriteTime, &writetime);
+        RegSetValueExW(cache_key, path, 0, REG_BINARY, other_data, other_size);
+        ok(!system_collection_has_family(L"wine_test"), "Cache entry wasn't used.\n");
+
+        /* Modifying the file invalidates the entry. */
+        set_file_writetime(path, &writetime, NULL);
+        ok(system_collection_has_family(L"wine_test"), "Test font wasn't added.\n");
+        heap_free(other_data);
+    }
+    else
+        skip("No other cached font.\n");
+
+    heap_free(buffer);
+    heap_free(data);
+
+done:
+    RegDeleteValueW(cache_key, path);
+    RegDeleteValueW(fonts_key, L"wine_test (TrueType)");
+    RegCloseKey(cache_key);
+    RegCloseKey(fonts_key);
+    DELETE_FONTFILE(path);
+}
+
 START_TEST(font)
 {
     IDWriteFactory *factory;
@@ -10393,6 +10531,7 @@ START_TEST(font)
     test_expiration_event();
     test_family_font_set();
     test_system_font_set();
+    test_system_font_cache();
     test_CreateFontCollectionFromFontSet();
 
     IDWriteFactory_Release(factory);
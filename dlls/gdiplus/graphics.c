@@ -17,6 +17,7 @@
  */
 
 #include <stdarg.h>
+#include <stdlib.h>
 #include <math.h>
 #include <limits.h>
 
@@ -1042,14 +1043,30 @@ static ARGB resample_bitmap_pixel(GDIPCONST GpRect *src_rect, LPBYTE bits, UINT
             return sample_bitmap_pixel(src_rect, bits, width, height,
                 leftx, topy, attributes);
 
-        topleft = sample_bitmap_pixel(src_rect, bits, width, height,
-            leftx, topy, attributes);
-        topright = sample_bitmap_pixel(src_rect, bits, width, height,
-            rightx, topy, attributes);
-        bottomleft = sample_bitmap_pixel(src_rect, bits, width, height,
-            leftx, bottomy, attributes);
-        bottomright = sample_bitmap_pixel(src_rect, bits, width, height,
-            rightx, bottomy, attributes);
+        if (leftx >= src_rect->X && rightx < src_rect->X + src_rect->Width &&
+            topy >= src_rect->Y && bottomy < src_rect->Y + src_rect->Height)
+        {
+            /* All four samples are inside the source area, which lies within the
+             * bitmap, so no wrapping is needed and they can be read directly. */
+            const ARGB *row = (const ARGB *)bits + (topy - src_rect->Y) * src_rect->Width;
+
+            topleft = row[leftx - src_rect->X];
+            topright = row[rightx - src_rect->X];
+            row += (bottomy - topy) * src_rect->Width;
+            bottomleft = row[leftx - src_rect->X];
+            bottomright = row[rightx - src_rect->X];
+        }
+        else
+        {
+            topleft = sample_bitmap_pixel(src_rect, bits, width, height,
+                leftx, topy, attributes);
+            topright = sample_bitmap_pixel(src_rect, bits, width, height,
+                rightx, topy, attributes);
+            bottomleft = sample_bitmap_pixel(src_rect, bits, width, height,
+                leftx, bottomy, attributes);
+            bottomright = sample_bitmap_pixel(src_rect, bits, width, height,
+                rightx, bottomy, attributes);
+        }
 
         x_offset = point->X - leftxf;
         top = blend_colors(topleft, topright, x_offset);
@@ -3267,18 +3284,20 @@ GpStatus WINGDIPAPI GdipDrawImagePointsRect(GpGraphics *graphics, GpImage *image
                 y_dx = dst_to_src_points[2].X - dst_to_src_points[0].X;
                 y_dy = dst_to_src_points[2].Y - dst_to_src_points[0].Y;
 
-                for (x=dst_area.left; x<dst_area.right; x++)
+                /* Walk the destination row by row. Each source coordinate is evaluated
+                 * as a single expression, so x87 builds keep extended precision
+                 * intermediates. */
+                for (y=dst_area.top; y<dst_area.bottom; y++)
                 {
-                    for (y=dst_area.top; y<dst_area.bottom; y++)
+                    ARGB *dst_color = (ARGB*)(dst_data + dst_stride * (y - dst_area.top));
+
+                    for (x=dst_area.left; x<dst_area.right; x++, dst_color++)
                     {
                         GpPointF src_pointf;
-                        ARGB *dst_color;
 
                         src_pointf.X = dst_to_src_points[0].X + x * x_dx + y * y_dx;
                         src_pointf.Y = dst_to_src_points[0].Y + x * x_dy + y * y_dy;
 
-                        dst_color = (ARGB*)(dst_data + dst_stride * (y - dst_area.top) + sizeof(ARGB) * (x - dst_area.left));
-
                         if (src_pointf.X >= srcx && src_pointf.X < srcx + srcwidth && src_pointf.Y >= srcy && src_pointf.Y < srcy+srcheight)
                             *dst_color = resample_bitmap_pixel(&src_area, src_data, bitmap->width, bitmap->height, &src_pointf,
                                                                imageAttributes, interpolation, offset_mode);
@@ -4320,6 +4339,320 @@ end:
     return retval;
 }
 
+#define AA_SUBSAMPLES 4
+#define AA_FULL_COVERAGE (256 * AA_SUBSAMPLES)
+
+struct aa_edge
+{
+    REAL x0, y0, x1, y1;
+    REAL dxdy;
+    INT dir;
+};
+
+struct aa_crossing
+{
+    REAL x;
+    INT dir;
+};
+
+static int __cdecl aa_edge_compare(const void *a, const void *b)
+{
+    const struct aa_edge *edge_a = a, *edge_b = b;
+
+    if (edge_a->y0 < edge_b->y0) return -1;
+    if (edge_a->y0 > edge_b->y0) return 1;
+    return 0;
+}
+
+static void aa_sort_crossings(struct aa_crossing *crossings, int count)
+{
+    int i, j;
+
+    /* Crossings are mostly ordered from one subscanline to the next. */
+    for (i=1; i<count; i++)
+    {
+        struct aa_crossing tmp = crossings[i];
+
+        for (j=i; j>0 && crossings[j-1].x > tmp.x; j--)
+            crossings[j] = crossings[j-1];
+        crossings[j] = tmp;
+    }
+}
+
+/* Adds the coverage of the span [x0, x1) on one subscanline. The coordinates
+ * are relative to the left of the row, in 1/256 pixel units. Fully covered
+ * pixels are accumulated in delta and summed up once the row is complete. */
+static void aa_add_span(INT *cover, INT *delta, INT x0, INT x1, INT *min_x, INT *max_x)
+{
+    INT i0 = x0 >> 8, i1 = x1 >> 8;
+
+    if (x0 >= x1) return;
+
+    if (i0 < *min_x) *min_x = i0;
+    if (((x1 - 1) >> 8) > *max_x) *max_x = (x1 - 1) >> 8;
+
+    if (i0 == i1)
+    {
+        cover[i0] += x1 - x0;
+        return;
+    }
+
+    cover[i0] += 256 - (x0 & 0xff);
+    delta[i0 + 1] += 256;
+    delta[i1] -= 256;
+    cover[i1] += x1 & 0xff;
+}
+
+/* Fills a path with anti-aliased edges. The path is flattened in device
+ * space and rasterized with AA_SUBSAMPLES subscanlines per pixel row,
+ * computing exact horizontal coverage on each subscanline. */
+static GpStatus SOFTWARE_GdipFillPathAntiAlias(GpGraphics *graphics, GpBrush *brush, GpPath *path)
+{
+    GpStatus stat;
+    GpPath *flat_path;
+    GpMatrix world_to_device;
+    GpRectF graphics_bounds;
+    GpRect fill_rect;
+    struct aa_edge *edges = NULL, **active = NULL;
+    struct aa_crossing *crossings = NULL;
+    INT *cover = NULL, *delta = NULL;
+    DWORD *pixel_data = NULL;
+    INT edge_count = 0, active_count = 0, next_edge = 0;
+    INT i, left, top, right, bottom, y;
+    REAL min_x, min_y, max_x, max_y, offset;
+
+    stat = GdipClonePath(path, &flat_path);
+    if (stat != Ok)
+        return stat;
+
+    gdi_transform_acquire(graphics);
+
+    stat = get_graphics_transform(graphics, WineCoordinateSpaceGdiDevice,
+        CoordinateSpaceWorld, &world_to_device);
+
+    if (stat == Ok)
+        stat = GdipFlattenPath(flat_path, &world_to_device, 0.25);
+
+    if (stat == Ok)
+        stat = get_graphics_device_bounds(graphics, &graphics_bounds);
+
+    if (stat != Ok || !flat_path->pathdata.Count)
+    {
+        gdi_transform_release(graphics);
+        GdipDeletePath(flat_path);
+        return stat;
+    }
+
+    edges = heap_alloc(sizeof(*edges) * flat_path->pathdata.Count);
+    if (!edges)
+    {
+        gdi_transform_release(graphics);
+        GdipDeletePath(flat_path);
+        return OutOfMemory;
+    }
+
+    /* Unless pixels are offset by half, pixel centers are on integer coordinates. */
+    if (graphics->pixeloffset == PixelOffsetModeHalf || graphics->pixeloffset == PixelOffsetModeHighQuality)
+        offset = 0.0;
+    else
+        offset = 0.5;
+
+    for (i=0; i<flat_path->pathdata.Count; i++)
+    {
+        flat_path->pathdata.Points[i].X += offset;
+        flat_path->pathdata.Points[i].Y += offset;
+    }
+
+    /* Build the edge list, closing every figure. */
+    min_x = max_x = flat_path->pathdata.Points[0].X;
+    min_y = max_y = flat_path->pathdata.Points[0].Y;
+
+    for (i=0; i<flat_path->pathdata.Count; i++)
+    {
+        const GpPointF *p0 = &flat_path->pathdata.Points[i], *p1;
+        int start;
+
+        if (p0->X < min_x) min_x = p0->X;
+        if (p0->X > max_x) max_x = p0->X;
+        if (p0->Y < min_y) min_y = p0->Y;
+        if (p0->Y > max_y) max_y = p0->Y;
+
+        if (i+1 < flat_path->pathdata.Count &&
+            (flat_path->pathdata.Types[i+1] & PathPointTypePathTypeMask) != PathPointTypeStart)
+            p1 = &flat_path->pathdata.Points[i+1];
+        else
+        {
+            for (start=i; start>0; start--)
+                if ((flat_path->pathdata.Types[start] & PathPointTypePathTypeMask) == PathPointTypeStart)
+                    break;
+            p1 = &flat_path->pathdata.Points[start];
+        }
+
+        if (p0->Y == p1->Y)
+            continue;
+
+        if (p0->Y < p1->Y)
+        {
+            edges[edge_count].x0 = p0->X;
+            edges[edge_count].y0 = p0->Y;
+            edges[edge_count].x1 = p1->X;
+            edges[edge_count].y1 = p1->Y;
+            edges[edge_count].dir = 1;
+        }
+        else
+        {
+            edges[edge_count].x0 = p1->X;
+            edges[edge_count].y0 = p1->Y;
+            edges[edge_count].x1 = p0->X;
+            edges[edge_count].y1 = p0->Y;
+            edges[edge_count].dir = -1;
+        }
+        edges[edge_count].dxdy = (edges[edge_count].x1 - edges[edge_count].x0) /
+            (edges[edge_count].y1 - edges[edge_count].y0);
+        edge_count++;
+    }
+
+    left = max(floorf(min_x), floorf(graphics_bounds.X));
+    top = max(floorf(min_y), floorf(graphics_bounds.Y));
+    right = min(ceilf(max_x), ceilf(graphics_bounds.X + graphics_bounds.Width));
+    bottom = min(ceilf(max_y), ceilf(graphics_bounds.Y + graphics_bounds.Height));
+
+    if (!edge_count || left >= right || top >= bottom)
+    {
+        heap_free(edges);
+        gdi_transform_release(graphics);
+        GdipDeletePath(flat_path);
+        return Ok;
+    }
+
+    fill_rect.X = left;
+    fill_rect.Y = top;
+    fill_rect.Width = right - left;
+    fill_rect.Height = bottom - top;
+
+    qsort(edges, edge_count, sizeof(*edges), aa_edge_compare);
+
+    active = heap_alloc(sizeof(*active) * edge_count);
+    crossings = heap_alloc(sizeof(*crossings) * edge_count);
+    cover = heap_alloc_zero(sizeof(*cover) * (fill_rect.Width + 1));
+    delta = heap_alloc_zero(sizeof(*delta) * (fill_rect.Width + 1));
+    pixel_data = heap_alloc_zero(sizeof(*pixel_data) * fill_rect.Width * fill_rect.Height);
+
+    if (!active || !crossings || !cover || !delta || !pixel_data)
+        stat = OutOfMemory;
+
+    if (stat == Ok)
+        stat = brush_fill_pixels(graphics, brush, pixel_data, &fill_rect, fill_rect.Width);
+
+    for (y=top; stat == Ok && y<bottom; y++)
+    {
+        DWORD *row = pixel_data + (y - top) * fill_rect.Width;
+        INT row_min = fill_rect.Width, row_max = -1, sum, x, s;
+
+        for (s=0; s<AA_SUBSAMPLES; s++)
+        {
+            REAL sample_y = y + (s + 0.5f) / AA_SUBSAMPLES;
+            INT crossing_count = 0, winding = 0, span_start = 0;
+
+            /* Update the active edge list. */
+            for (i=0; i<active_count;)
+            {
+                if (active[i]->y1 <= sample_y)
+                    active[i] = active[--active_count];
+                else
+                    i++;
+            }
+
+            while (next_edge < edge_count && edges[next_edge].y0 <= sample_y)
+            {
+                if (edges[next_edge].y1 > sample_y)
+                    active[active_count++] = &edges[next_edge];
+                next_edge++;
+            }
+
+            for (i=0; i<active_count; i++)
+            {
+                crossings[crossing_count].x = active[i]->x0 + (sample_y - active[i]->y0) * active[i]->dxdy;
+                crossings[crossing_count].dir = active[i]->dir;
+                crossing_count++;
+            }
+
+            aa_sort_crossings(crossings, crossing_count);
+
+            for (i=0; i<crossing_count; i++)
+            {
+                BOOL was_inside, is_inside;
+                INT cx;
+
+                if (flat_path->fill == FillModeAlternate)
+                {
+                    was_inside = winding & 1;
+                    winding++;
+                    is_inside = winding & 1;
+                }
+                else
+                {
+                    was_inside = winding != 0;
+                    winding += crossings[i].dir;
+                    is_inside = winding != 0;
+                }
+
+                if (was_inside == is_inside)
+                    continue;
+
+                if (crossings[i].x <= left)
+                    cx = 0;
+                else if (crossings[i].x >= right)
+                    cx = fill_rect.Width * 256;
+                else
+                    cx = gdip_round((crossings[i].x - left) * 256);
+
+                if (is_inside)
+                    span_start = cx;
+                else
+                    aa_add_span(cover, delta, span_start, cx, &row_min, &row_max);
+            }
+        }
+
+        /* Apply the accumulated coverage to the brush pixels of this row. */
+        sum = 0;
+        for (x=0; x<fill_rect.Width; x++)
+        {
+            INT coverage;
+
+            if (x >= row_min && x <= row_max + 1)
+            {
+                sum += delta[x];
+                coverage = cover[x] + sum;
+                cover[x] = delta[x] = 0;
+            }
+            else
+                coverage = 0;
+
+            if (coverage <= 0)
+                row[x] = 0;
+            else if (coverage < AA_FULL_COVERAGE)
+                row[x] = (row[x] & 0xffffff) | ((row[x] >> 24) * coverage / AA_FULL_COVERAGE) << 24;
+        }
+        cover[fill_rect.Width] = delta[fill_rect.Width] = 0;
+    }
+
+    if (stat == Ok)
+        stat = alpha_blend_pixels(graphics, fill_rect.X, fill_rect.Y, (BYTE*)pixel_data,
+            fill_rect.Width, fill_rect.Height, fill_rect.Width * 4, PixelFormat32bppARGB);
+
+    heap_free(pixel_data);
+    heap_free(delta);
+    heap_free(cover);
+    heap_free(crossings);
+    heap_free(active);
+    heap_free(edges);
+    gdi_transform_release(graphics);
+    GdipDeletePath(flat_path);
+
+    return stat;
+}
+
 static GpStatus SOFTWARE_GdipFillPath(GpGraphics *graphics, GpBrush *brush, GpPath *path)
 {
     GpStatus stat;
@@ -4328,6 +4661,12 @@ static GpStatus SOFTWARE_GdipFillPath(GpGraphics *graphics, GpBrush *brush, GpPa
     if (!brush_can_fill_pixels(brush))
         return NotImplemented;
 
+    /* Partially covered pixels cannot be blended in SourceCopy mode. */
+    if ((graphics->smoothing == SmoothingModeAntiAlias ||
+         graphics->smoothing == SmoothingModeHighQuality) &&
+        graphics->compmode != CompositingModeSourceCopy)
+        return SOFTWARE_GdipFillPathAntiAlias(graphics, brush, path);
+
     /* FIXME: This could probably be done more efficiently without regions. */
 
     stat = GdipCreateRegionPath(path, &rgn);
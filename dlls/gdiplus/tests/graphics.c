@@ -6654,6 +6654,68 @@ static void test_GdipFillRectanglesOnBitmapTextureBrush(void)
     GdipFree(src_img_data);
 }
 
+static void test_antialias_fill(void)
+{
+    GpStatus status;
+    GpBitmap *bitmap;
+    GpGraphics *graphics;
+    GpSolidFill *brush;
+    GpPath *path;
+    ARGB color;
+
+    status = GdipCreateBitmapFromScan0(8, 8, 0, PixelFormat32bppARGB, NULL, &bitmap);
+    expect(Ok, status);
+    status = GdipGetImageGraphicsContext((GpImage *)bitmap, &graphics);
+    expect(Ok, status);
+    status = GdipSetSmoothingMode(graphics, SmoothingModeAntiAlias);
+    expect(Ok, status);
+    status = GdipCreateSolidFill(0xff0000ff, &brush);
+    expect(Ok, status);
+
+    /* Edges on pixel boundaries are not blended. */
+    status = GdipCreatePath(FillModeAlternate, &path);
+    expect(Ok, status);
+    status = GdipAddPathRectangle(path, 0.5, 0.5, 3.0, 3.0);
+    expect(Ok, status);
+    status = GdipFillPath(graphics, (GpBrush *)brush, path);
+    expect(Ok, status);
+    GdipDeletePath(path);
+
+    status = GdipBitmapGetPixel(bitmap, 0, 0, &color);
+    expect(Ok, status);
+    expect(0, color);
+    status = GdipBitmapGetPixel(bitmap, 1, 1, &color);
+    expect(Ok, status);
+    expect(0xff0000ff, color);
+    status = GdipBitmapGetPixel(bitmap, 3, 3, &color);
+    expect(Ok, status);
+    expect(0xff0000ff, color);
+    status = GdipBitmapGetPixel(bitmap, 4, 4, &color);
+    expect(Ok, status);
+    expect(0, color);
+
+    /* Edges crossing the middle of a pixel cover about half of it. */
+    status = GdipCreatePath(FillModeAlternate, &path);
+    expect(Ok, status);
+    status = GdipAddPathRectangle(path, 5.0, 1.0, 2.0, 6.0);
+    expect(Ok, status);
+    status = GdipFillPath(graphics, (GpBrush *)brush, path);
+    expect(Ok, status);
+    GdipDeletePath(path);
+
+    status = GdipBitmapGetPixel(bitmap, 5, 3, &color);
+    expect(Ok, status);
+    ok((color & 0xffffff) == 0xff && (color >> 24) > 0x60 && (color >> 24) < 0xa0,
+       "Expected a partially covered pixel, got %.8x\n", color);
+    status = GdipBitmapGetPixel(bitmap, 6, 3, &color);
+    expect(Ok, status);
+    expect(0xff0000ff, color);
+
+    GdipDeleteBrush((GpBrush *)brush);
+    GdipDeleteGraphics(graphics);
+    GdipDisposeImage((GpImage *)bitmap);
+}
+
 static void test_GdipDrawImagePointsRectOnMemoryDC(void)
 {
     ARGB color[6] = {0,0,0,0,0,0};
@@ -7313,6 +7375,7 @@ START_TEST(graphics)
     test_GdipFillRectanglesOnMemoryDCSolidBrush();
     test_GdipFillRectanglesOnMemoryDCTextureBrush();
     test_GdipFillRectanglesOnBitmapTextureBrush();
+    test_antialias_fill();
     test_GdipDrawImagePointsRectOnMemoryDC();
     test_container_rects();
     test_GdipGraphicsSetAbort();
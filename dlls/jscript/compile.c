@@ -2470,6 +2470,7 @@ void release_bytecode(bytecode_t *code)
     heap_pool_free(&code->heap);
     heap_free(code->bstr_pool);
     heap_free(code->str_pool);
+    heap_free(code->prop_cache);
     heap_free(code->instrs);
     heap_free(code);
 }
@@ -2762,6 +2763,12 @@ HRESULT compile_script(script_ctx_t *ctx, const WCHAR *code, UINT64 source_conte
         return DISP_E_EXCEPTION;
     }
 
+    compiler.code->prop_cache = heap_alloc_zero(compiler.code_off * sizeof(*compiler.code->prop_cache));
+    if(!compiler.code->prop_cache) {
+        release_bytecode(compiler.code);
+        return E_OUTOFMEMORY;
+    }
+
     if(named_item) {
         compiler.code->named_item = named_item;
         named_item->ref++;
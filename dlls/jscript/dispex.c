@@ -2871,6 +2871,29 @@ HRESULT jsdisp_get_id(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, DISPID *
     return DISP_E_UNKNOWNNAME;
 }
 
+/*
+ * Same as jsdisp_get_id, but first tries the DISPID cached by the caller. Property slots
+ * are never reused for a different name, so the cached id is valid for any object that
+ * has a live property of the same name in that slot. This includes all objects that had
+ * their properties added in the same order.
+ */
+HRESULT jsdisp_get_id_cached(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, DISPID *cache, DISPID *id)
+{
+    dispex_prop_t *prop;
+    unsigned idx;
+    HRESULT hres;
+
+    if(!override_idx(jsdisp, name, &idx) && (prop = get_prop(jsdisp, *cache)) && !wcscmp(prop->name, name)) {
+        *id = *cache;
+        return S_OK;
+    }
+
+    hres = jsdisp_get_id(jsdisp, name, flags, id);
+    if(SUCCEEDED(hres))
+        *cache = *id;
+    return hres;
+}
+
 HRESULT jsdisp_call_value(jsdisp_t *jsfunc, IDispatch *jsthis, WORD flags, unsigned argc, jsval_t *argv, jsval_t *r)
 {
     HRESULT hres;
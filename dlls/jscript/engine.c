@@ -503,6 +503,21 @@ static HRESULT disp_get_id(script_ctx_t *ctx, IDispatch *disp, const WCHAR *name
     return hres;
 }
 
+static HRESULT disp_get_id_cached(script_ctx_t *ctx, IDispatch *disp, const WCHAR *name, BSTR name_bstr, DWORD flags,
+                                  DISPID *cache, DISPID *id)
+{
+    jsdisp_t *jsdisp;
+    HRESULT hres;
+
+    jsdisp = iface_to_jsdisp(disp);
+    if(!jsdisp)
+        return disp_get_id(ctx, disp, name, name_bstr, flags, id);
+
+    hres = jsdisp_get_id_cached(jsdisp, name, flags, cache, id);
+    jsdisp_release(jsdisp);
+    return hres;
+}
+
 static HRESULT disp_cmp(IDispatch *disp1, IDispatch *disp2, BOOL *ret)
 {
     IObjectIdentity *identity;
@@ -715,13 +730,16 @@ local_ref_t *lookup_local(const function_code_t *function, const WCHAR *identifi
 }
 
 /* ECMA-262 3rd Edition    10.1.4 */
-static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *ret)
+static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, DISPID *cache, exprval_t *ret)
 {
+    DISPID id = 0, no_cache = 0;
     scope_chain_t *scope;
     named_item_t *item;
-    DISPID id = 0;
     HRESULT hres;
 
+    if(!cache)
+        cache = &no_cache;
+
     TRACE("%s\n", debugstr_w(identifier));
 
     if(ctx->call_ctx) {
@@ -768,7 +786,7 @@ static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *re
 
         item = ctx->call_ctx->bytecode->named_item;
         if(item) {
-            hres = jsdisp_get_id(item->script_obj, identifier, 0, &id);
+            hres = jsdisp_get_id_cached(item->script_obj, identifier, 0, cache, &id);
             if(SUCCEEDED(hres)) {
                 exprval_set_disp_ref(ret, to_disp(item->script_obj), id);
                 return S_OK;
@@ -783,7 +801,7 @@ static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *re
         }
     }
 
-    hres = jsdisp_get_id(ctx->global, identifier, 0, &id);
+    hres = jsdisp_get_id_cached(ctx->global, identifier, 0, cache, &id);
     if(SUCCEEDED(hres)) {
         exprval_set_disp_ref(ret, to_disp(ctx->global), id);
         return S_OK;
@@ -834,6 +852,12 @@ static inline double get_op_double(script_ctx_t *ctx)
     return frame->bytecode->instrs[frame->ip].u.dbl;
 }
 
+static inline DISPID *get_op_prop_cache(script_ctx_t *ctx)
+{
+    call_frame_t *frame = ctx->call_ctx;
+    return &frame->bytecode->prop_cache[frame->ip];
+}
+
 static inline void jmp_next(script_ctx_t *ctx)
 {
     ctx->call_ctx->ip++;
@@ -1290,7 +1314,7 @@ static HRESULT interp_member(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx, obj, arg, arg, 0, &id);
+    hres = disp_get_id_cached(ctx, obj, arg, arg, 0, get_op_prop_cache(ctx), &id);
     if(SUCCEEDED(hres)) {
         hres = disp_propget(ctx, obj, id, &v);
     }else if(hres == DISP_E_UNKNOWNNAME) {
@@ -1332,7 +1356,7 @@ static HRESULT interp_memberid(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx, obj, name, NULL, arg, &id);
+    hres = disp_get_id_cached(ctx, obj, name, NULL, arg, get_op_prop_cache(ctx), &id);
     jsstr_release(name_str);
     if(SUCCEEDED(hres)) {
         ref.type = EXPRVAL_IDREF;
@@ -1453,7 +1477,7 @@ static HRESULT interp_identifier_ref(script_ctx_t *ctx, BSTR identifier, unsigne
     exprval_t exprval;
     HRESULT hres;
 
-    hres = identifier_eval(ctx, identifier, &exprval);
+    hres = identifier_eval(ctx, identifier, get_op_prop_cache(ctx), &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -1487,7 +1511,7 @@ static HRESULT identifier_value(script_ctx_t *ctx, BSTR identifier)
     jsval_t v;
     HRESULT hres;
 
-    hres = identifier_eval(ctx, identifier, &exprval);
+    hres = identifier_eval(ctx, identifier, get_op_prop_cache(ctx), &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -2101,7 +2125,7 @@ static HRESULT interp_delete_ident(script_ctx_t *ctx)
 
     TRACE("%s\n", debugstr_w(arg));
 
-    hres = identifier_eval(ctx, arg, &exprval);
+    hres = identifier_eval(ctx, arg, NULL, &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -2212,7 +2236,7 @@ static HRESULT interp_typeofident(script_ctx_t *ctx)
 
     TRACE("%s\n", debugstr_w(arg));
 
-    hres = identifier_eval(ctx, arg, &exprval);
+    hres = identifier_eval(ctx, arg, get_op_prop_cache(ctx), &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -3124,7 +3148,7 @@ static HRESULT bind_event_target(script_ctx_t *ctx, function_code_t *func, jsdis
     jsval_t v;
     HRESULT hres;
 
-    hres = identifier_eval(ctx, func->event_target, &exprval);
+    hres = identifier_eval(ctx, func->event_target, NULL, &exprval);
     if(FAILED(hres))
         return hres;
 
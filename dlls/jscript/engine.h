@@ -207,6 +207,8 @@ struct _bytecode_t {
     unsigned str_pool_size;
     unsigned str_cnt;
 
+    DISPID *prop_cache; /* per-instruction DISPID of the last property resolved by name */
+
     struct list entry;
 };
 
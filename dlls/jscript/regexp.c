@@ -32,6 +32,7 @@
  */
 
 #include <assert.h>
+#include <wchar.h>
 
 #include "jscript.h"
 #include "regexp.h"
@@ -3070,6 +3071,26 @@ good:
     return x;
 }
 
+/*
+ * Find the next position at or after cp where the literal prefix of the regexp
+ * occurs, or NULL if there is none. This lets us skip over input that can't
+ * start a match without running the bytecode at every position.
+ */
+static const WCHAR *FindPrefix(const regexp_t *re, const WCHAR *cp, const WCHAR *cpend)
+{
+    const WCHAR *ptr;
+
+    while ((size_t)(cpend - cp) >= re->prefix_len) {
+        ptr = wmemchr(cp, re->prefix[0], cpend - cp - re->prefix_len + 1);
+        if (!ptr)
+            break;
+        if (!memcmp(ptr + 1, re->prefix + 1, (re->prefix_len - 1) * sizeof(WCHAR)))
+            return ptr;
+        cp = ptr + 1;
+    }
+    return NULL;
+}
+
 static match_state_t *MatchRegExp(REGlobalData *gData, match_state_t *x)
 {
     match_state_t *result;
@@ -3082,6 +3103,11 @@ static match_state_t *MatchRegExp(REGlobalData *gData, match_state_t *x)
      * in order to detect end-of-input/line condition.
      */
     for (cp2 = cp; cp2 <= gData->cpend; cp2++) {
+        if (gData->regexp->prefix_len && !(gData->regexp->flags & REG_STICKY)) {
+            cp2 = FindPrefix(gData->regexp, cp2, gData->cpend);
+            if (!cp2)
+                return NULL;
+        }
         gData->skipped = cp2 - cp;
         x->cp = cp2;
         for (j = 0; j < gData->regexp->parenCount; j++)
@@ -3178,6 +3204,42 @@ HRESULT regexp_execute(regexp_t *regexp, void *cx, heap_pool_t *pool,
     return S_OK;
 }
 
+/*
+ * If every match has to start with a case sensitive literal, remember it so
+ * that MatchRegExp can scan for it. Capturing parens are zero width, so we
+ * can look through them.
+ */
+static void SetPrefix(regexp_t *re)
+{
+    jsbytecode *pc = re->program;
+    size_t index, length;
+
+    re->prefix = NULL;
+    re->prefix_len = 0;
+
+    while (*pc == REOP_LPAREN)
+        pc = ReadCompactIndex(pc + 1, &index);
+
+    switch (*pc++) {
+      case REOP_FLAT:
+        pc = ReadCompactIndex(pc, &index);
+        ReadCompactIndex(pc, &length);
+        re->prefix = re->source + index;
+        re->prefix_len = length;
+        break;
+      case REOP_FLAT1:
+        re->prefix_char = *pc;
+        re->prefix = &re->prefix_char;
+        re->prefix_len = 1;
+        break;
+      case REOP_UCFLAT1:
+        re->prefix_char = GET_ARG(pc);
+        re->prefix = &re->prefix_char;
+        re->prefix_len = 1;
+        break;
+    }
+}
+
 void regexp_destroy(regexp_t *re)
 {
     if (re->classList) {
@@ -3281,6 +3343,7 @@ regexp_t* regexp_new(void *cx, heap_pool_t *pool, const WCHAR *str,
     re->parenCount = state.parenCount;
     re->source = str;
     re->source_len = str_len;
+    SetPrefix(re);
 
 out:
     heap_pool_clear(mark);
@@ -2113,3 +2113,36 @@ function test_es5_keywords() {
     ok(tmp === true, "Expected exception for 'const c1 = 1;'");
 }
 test_es5_keywords();
+
+function test_prop_cache() {
+    function get_x(o) { return o.x; }
+    function set_x(o, v) { o.x = v; }
+    var i, o1 = {x: 1, y: 2}, o2 = {y: 3, x: 4}, o3 = {x: 5}, p = {x: 6}, o4;
+
+    for(i = 0; i < 3; i++) {
+        ok(get_x(o1) === 1, "get_x(o1) = " + get_x(o1));
+        ok(get_x(o2) === 4, "get_x(o2) = " + get_x(o2));
+        ok(get_x(o3) === 5, "get_x(o3) = " + get_x(o3));
+    }
+
+    delete o3.x;
+    ok(get_x(o3) === undefined, "get_x(o3) after delete = " + get_x(o3));
+    set_x(o3, 7);
+    ok(get_x(o3) === 7, "get_x(o3) after set = " + get_x(o3));
+
+    function C() {}
+    C.prototype = p;
+    o4 = new C();
+    ok(get_x(o4) === 6, "get_x(o4) = " + get_x(o4));
+    set_x(o4, 8);
+    ok(get_x(o4) === 8, "get_x(o4) after set = " + get_x(o4));
+    ok(p.x === 6, "p.x = " + p.x);
+    delete o4.x;
+    ok(get_x(o4) === 6, "get_x(o4) after delete = " + get_x(o4));
+    delete p.x;
+    ok(get_x(o4) === undefined, "get_x(o4) after prototype delete = " + get_x(o4));
+
+    for(i = 0; i < 3; i++)
+        ok(typeof(test_prop_cache) === "function", "typeof(test_prop_cache) = " + typeof(test_prop_cache));
+}
+test_prop_cache();
@@ -713,4 +713,20 @@ ok(re.ignoreCase === false, "re.ignoreCase = " + re.ignoreCase);
 ok(re.multiline === true, "re.multiline = " + re.multiline);
 ok(re.global === true, "re.global = " + re.global);
 
+m = "xxabxab(abc)abcab".match(/(ab)c/g);
+ok(m.length === 2, "m.length = " + m.length);
+ok(m[0] === "abc", "m[0] = " + m[0]);
+ok(m[1] === "abc", "m[1] = " + m[1]);
+
+m = /(a)(b)c/.exec("ababcab");
+ok(m.index === 2, "m.index = " + m.index);
+ok(m[1] === "a", "m[1] = " + m[1]);
+ok(m[2] === "b", "m[2] = " + m[2]);
+
+m = "abxabab".replace(/ab(?!x)/g, "_");
+ok(m === "abx__", "m = " + m);
+
+m = "aaaa".search(/ab/);
+ok(m === -1, "m = " + m);
+
 reportSuccess();
@@ -2529,6 +2529,15 @@ static void inc_str_pos( const WCHAR **str, int *len, unsigned int *dpos, unsign
 }
 
 
+/* Printable ASCII characters other than hyphen and apostrophe don't decompose and
+ * have a non-zero primary weight, so a run of them that is identical in both strings
+ * is consumed in lockstep at every weight level and can't affect the result. */
+static inline BOOL is_skippable_prefix_char( WCHAR ch )
+{
+    return ch >= 0x20 && ch < 0x7f && ch != '-' && ch != '\'';
+}
+
+
 static int compare_weights(int flags, const WCHAR *str1, int len1,
                            const WCHAR *str2, int len2, enum weight type )
 {
@@ -3086,6 +3095,14 @@ INT WINAPI CompareStringEx( const WCHAR *locale, DWORD flags, const WCHAR *str1,
     if (len1 < 0) len1 = lstrlenW(str1);
     if (len2 < 0) len2 = lstrlenW(str2);
 
+    while (len1 && len2 && *str1 == *str2 && is_skippable_prefix_char( *str1 ))
+    {
+        str1++;
+        str2++;
+        len1--;
+        len2--;
+    }
+
     ret = compare_weights( flags, str1, len1, str2, len2, UNICODE_WEIGHT );
     if (!ret)
     {
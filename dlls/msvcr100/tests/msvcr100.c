@@ -170,8 +170,8 @@ struct SchedulerVtbl {
     unsigned int (__thiscall *Release)(Scheduler*);
     void (__thiscall *RegisterShutdownEvent)(Scheduler*,HANDLE);
     void (__thiscall *Attach)(Scheduler*);
-    /* CreateScheduleGroup */
-    /* ScheduleTask */
+    void* (__thiscall *CreateScheduleGroup)(Scheduler*);
+    void (__thiscall *ScheduleTask)(Scheduler*,void (__cdecl*)(void*),void*);
 };
 
 static int* (__cdecl *p_errno)(void);
@@ -956,8 +956,26 @@ static void test_ExternalContextBase(void)
     CloseHandle(thread);
 }
 
+struct schedule_task_data
+{
+    HANDLE event;
+    Scheduler *scheduler;
+    Scheduler *current_scheduler;
+    DWORD thread_id;
+};
+
+static void __cdecl schedule_task_proc(void *arg)
+{
+    struct schedule_task_data *data = arg;
+
+    data->current_scheduler = p_CurrentScheduler_Get();
+    data->thread_id = GetCurrentThreadId();
+    SetEvent(data->event);
+}
+
 static void test_Scheduler(void)
 {
+    struct schedule_task_data data;
     Scheduler *scheduler, *current_scheduler;
     SchedulerPolicy policy;
     unsigned int i;
@@ -985,6 +1003,18 @@ static void test_Scheduler(void)
 
     i = call_func1(scheduler->vtable->GetNumberOfVirtualProcessors, scheduler);
     ok(i == 1, "Scheduler::GetNumberOfVirtualProcessors() = %u\n", i);
+
+    data.event = CreateEventW(NULL, FALSE, FALSE, NULL);
+    data.scheduler = scheduler;
+    data.current_scheduler = NULL;
+    data.thread_id = 0;
+    call_func3(scheduler->vtable->ScheduleTask, scheduler, schedule_task_proc, &data);
+    i = WaitForSingleObject(data.event, 5000);
+    ok(i == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", i);
+    ok(data.current_scheduler == scheduler, "CurrentScheduler::Get() = %p, expected %p\n",
+            data.current_scheduler, scheduler);
+    ok(data.thread_id && data.thread_id != GetCurrentThreadId(), "task ran on thread %x\n", data.thread_id);
+    CloseHandle(data.event);
     call_func1(scheduler->vtable->Release, scheduler);
     call_func1(p_SchedulerPolicy_dtor, &policy);
 }
@@ -23,6 +23,7 @@
 
 #include "windef.h"
 #include "winternl.h"
+#include "wine/exception.h"
 #include "wine/debug.h"
 #include "msvcrt.h"
 #include "cxx.h"
@@ -135,8 +136,11 @@ typedef struct {
     int shutdown_size;
     HANDLE *shutdown_events;
     CRITICAL_SECTION cs;
+    TP_POOL *pool;
+    TP_CALLBACK_ENVIRON pool_env;
 } ThreadScheduler;
 extern const vtable_ptr ThreadScheduler_vtable;
+void __cdecl CurrentScheduler_Detach(void);
 
 typedef struct {
     Scheduler *scheduler;
@@ -1107,6 +1111,9 @@ static void ThreadScheduler_dtor(ThreadScheduler *this)
         SetEvent(this->shutdown_events[i]);
     operator_delete(this->shutdown_events);
 
+    if(this->pool)
+        CloseThreadpool(this->pool);
+
     this->cs.DebugInfo->Spare[0] = 0;
     DeleteCriticalSection(&this->cs);
 }
@@ -1218,18 +1225,114 @@ DEFINE_THISCALL_WRAPPER(ThreadScheduler_CreateScheduleGroup, 4)
     return NULL;
 }
 
+typedef struct
+{
+    void (__cdecl *proc)(void*);
+    void *data;
+    ThreadScheduler *scheduler;
+} schedule_task_arg;
+
+static LONG CALLBACK schedule_task_except(EXCEPTION_POINTERS *pexc)
+{
+    if(pexc->ExceptionRecord->ExceptionCode != CXX_EXCEPTION)
+        return EXCEPTION_CONTINUE_SEARCH;
+    return EXCEPTION_EXECUTE_HANDLER;
+}
+
+static void WINAPI schedule_task_proc(PTP_CALLBACK_INSTANCE instance, void *context)
+{
+    schedule_task_arg arg;
+    BOOL detach = FALSE;
+
+    arg = *(schedule_task_arg*)context;
+    operator_delete(context);
+
+    if(&arg.scheduler->scheduler != get_current_scheduler()) {
+        ThreadScheduler_Attach(arg.scheduler);
+        detach = TRUE;
+    }
+
+    /* don't let C++ exceptions thrown by the task unwind into the thread pool */
+    __TRY
+    {
+        arg.proc(arg.data);
+    }
+    __EXCEPT(schedule_task_except)
+    {
+        ERR("unhandled exception in task %p(%p)\n", arg.proc, arg.data);
+    }
+    __ENDTRY
+
+    if(detach)
+        CurrentScheduler_Detach();
+    ThreadScheduler_Release(arg.scheduler);
+}
+
+/* Tasks are run on a thread pool owned by the scheduler, with at least
+ * MinConcurrency threads. The number of threads isn't capped at virt_proc_no,
+ * tasks may block waiting for other tasks. */
+static TP_CALLBACK_ENVIRON* ThreadScheduler_get_pool_env(ThreadScheduler *this)
+{
+    unsigned int min_concurrency;
+    TP_POOL *pool;
+
+    if(this->pool)
+        return &this->pool_env;
+
+    EnterCriticalSection(&this->cs);
+    if(!this->pool) {
+        if(!(pool = CreateThreadpool(NULL))) {
+            LeaveCriticalSection(&this->cs);
+            return NULL;
+        }
+
+        min_concurrency = SchedulerPolicy_GetPolicyValue(&this->policy, MinConcurrency);
+        if(min_concurrency > this->virt_proc_no)
+            min_concurrency = this->virt_proc_no;
+        SetThreadpoolThreadMinimum(pool, min_concurrency);
+
+        memset(&this->pool_env, 0, sizeof(this->pool_env));
+        this->pool_env.Version = 1;
+        this->pool_env.Pool = pool;
+        InterlockedExchangePointer((void**)&this->pool, pool);
+    }
+    LeaveCriticalSection(&this->cs);
+    return &this->pool_env;
+}
+
 DEFINE_THISCALL_WRAPPER(ThreadScheduler_ScheduleTask_loc, 16)
 void __thiscall ThreadScheduler_ScheduleTask_loc(ThreadScheduler *this,
         void (__cdecl *proc)(void*), void* data, /*location*/void *placement)
 {
-    FIXME("(%p %p %p %p) stub\n", this, proc, data, placement);
+    TP_CALLBACK_ENVIRON *env;
+    schedule_task_arg *arg;
+
+    TRACE("(%p %p %p %p)\n", this, proc, data, placement);
+
+    arg = operator_new(sizeof(*arg));
+    arg->proc = proc;
+    arg->data = data;
+    arg->scheduler = this;
+    ThreadScheduler_Reference(this);
+
+    if(!(env = ThreadScheduler_get_pool_env(this)) ||
+            !TrySubmitThreadpoolCallback(schedule_task_proc, arg, env)) {
+        scheduler_resource_allocation_error e;
+
+        ThreadScheduler_Release(this);
+        operator_delete(arg);
+        scheduler_resource_allocation_error_ctor_name(&e, NULL,
+                HRESULT_FROM_WIN32(GetLastError()));
+        _CxxThrowException(&e, &scheduler_resource_allocation_error_exception_type);
+    }
 }
 
 DEFINE_THISCALL_WRAPPER(ThreadScheduler_ScheduleTask, 12)
 void __thiscall ThreadScheduler_ScheduleTask(ThreadScheduler *this,
         void (__cdecl *proc)(void*), void* data)
 {
-    FIXME("(%p %p %p) stub\n", this, proc, data);
+    TRACE("(%p %p %p)\n", this, proc, data);
+    ThreadScheduler_ScheduleTask_loc(this, proc, data, NULL);
 }
 
 DEFINE_THISCALL_WRAPPER(ThreadScheduler_IsAvailableLocation, 8)
@@ -1279,6 +1382,7 @@ static ThreadScheduler* ThreadScheduler_ctor(ThreadScheduler *this,
 
     this->shutdown_count = this->shutdown_size = 0;
     this->shutdown_events = NULL;
+    this->pool = NULL;
 
     InitializeCriticalSection(&this->cs);
     this->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": ThreadScheduler");
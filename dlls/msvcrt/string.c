@@ -742,6 +742,53 @@ static inline BOOL bnum_to_mant(struct bnum *b, ULONGLONG *m)
     return TRUE;
 }
 
+/* Converts numbers with up to 18 significant digits and a small decimal
+ * exponent using 64-bit arithmetic only. */
+static BOOL fpnum_parse_fast(int sign, ULONGLONG d, int exp10, struct fpnum *ret)
+{
+    static const ULONGLONG p10[] = {
+        1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull,
+        10000000ull, 100000000ull, 1000000000ull, 10000000000ull,
+        100000000000ull, 1000000000000ull, 10000000000000ull,
+        100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+        100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull
+    };
+    ULONGLONG q, r, div;
+    enum fpmod round;
+    int e2 = 0;
+
+    if(exp10 >= 0) {
+        if(exp10 >= ARRAY_SIZE(p10) || d > UI64_MAX / p10[exp10])
+            return FALSE;
+        *ret = fpnum(sign, 0, d * p10[exp10], FP_ROUND_ZERO);
+        return TRUE;
+    }
+
+    if(-exp10 > 18)
+        return FALSE;
+    div = p10[-exp10];
+
+    /* binary long division, until the quotient has 64 significant bits */
+    q = d / div;
+    r = d % div;
+    while(q < (ULONGLONG)1 << 63) {
+        r <<= 1;
+        q <<= 1;
+        if(r >= div) {
+            r -= div;
+            q |= 1;
+        }
+        e2--;
+    }
+
+    if(!r) round = FP_ROUND_ZERO;
+    else if(r < div - r) round = FP_ROUND_DOWN;
+    else if(r == div - r) round = FP_ROUND_EVEN;
+    else round = FP_ROUND_UP;
+    *ret = fpnum(sign, e2, q, round);
+    return TRUE;
+}
+
 static struct fpnum fpnum_parse_bnum(wchar_t (*get)(void *ctx), void (*unget)(void *ctx),
         void *ctx, pthreadlocinfo locinfo, BOOL ldouble, struct bnum *b)
 {
@@ -917,6 +964,21 @@ static struct fpnum fpnum_parse_bnum(wchar_t (*get)(void *ctx), void (*unget)(vo
     if(!b->data[bnum_idx(b, b->e-1)])
         return fpnum(sign, 0, 0, 0);
 
+    if(!ldouble && b->e - b->b <= 2 && dp > -40 && dp < 40) {
+        struct fpnum ret;
+        ULONGLONG d = b->data[bnum_idx(b, b->e-1)];
+        int digits = limb_digits;
+
+        /* the top limb is full, the low one holds limb_digits digits */
+        if(b->e - b->b == 2) {
+            d = d * (limb_digits == LIMB_DIGITS ? LIMB_MAX : p10s[limb_digits])
+                + b->data[bnum_idx(b, b->b)];
+            digits = LIMB_DIGITS + limb_digits;
+        }
+        if(fpnum_parse_fast(sign, d, dp - digits, &ret))
+            return ret;
+    }
+
     /* Fill last limb with 0 if needed */
     if(b->b+1 != b->e) {
         for(; limb_digits != LIMB_DIGITS; limb_digits++)
@@ -1989,6 +1989,37 @@ static void test__strtod(void)
         { ".00", 3, 0 },
         { "-0.", 3, 0 },
         { "0e13", 4, 0 },
+        { "9007199254740993", 16, 9007199254740993.0 },
+        { "123456789012345678", 18, 123456789012345678.0 },
+        { "1e19", 4, 1e19 },
+        { "0.3", 3, 0.3 },
+        { "1.00000000000000022", 19, 1.00000000000000022 },
+        { "-0.000123456789012345678", 24, -0.000123456789012345678 },
+        { "4.35", 4, 4.35 },
+        { "9876543210", 10, 9876543210.0 },
+        { "98765.43210", 11, 98765.43210 },
+        { "0.9876543210", 12, 0.9876543210 },
+        { "98765432109", 11, 98765432109.0 },
+        { "98765.432109", 12, 98765.432109 },
+        { "0.98765432109", 13, 0.98765432109 },
+        { "987654321098", 12, 987654321098.0 },
+        { "987654.321098", 13, 987654.321098 },
+        { "0.987654321098", 14, 0.987654321098 },
+        { "9876543210987", 13, 9876543210987.0 },
+        { "987654.3210987", 14, 987654.3210987 },
+        { "0.9876543210987", 15, 0.9876543210987 },
+        { "98765432109876", 14, 98765432109876.0 },
+        { "9876543.2109876", 15, 9876543.2109876 },
+        { "0.98765432109876", 16, 0.98765432109876 },
+        { "987654321098765", 15, 987654321098765.0 },
+        { "9876543.21098765", 16, 9876543.21098765 },
+        { "0.987654321098765", 17, 0.987654321098765 },
+        { "9876543210987654", 16, 9876543210987654.0 },
+        { "98765432.10987654", 17, 98765432.10987654 },
+        { "0.9876543210987654", 18, 0.9876543210987654 },
+        { "98765432109876543", 17, 98765432109876543.0 },
+        { "98765432.109876543", 18, 98765432.109876543 },
+        { "0.98765432109876543", 19, 0.98765432109876543 },
     };
     const char overflow[] = "1d9999999999999999999";
 
@@ -2839,6 +2839,43 @@ static ULONG EmbeddedComplexMemorySize(PMIDL_STUB_MESSAGE pStubMsg,
 }
 
 
+/* Returns the number of leading members of a complex struct description that
+ * are base types with the same memory and wire layout, along with their total
+ * size, so that they can be copied in a single block. */
+static unsigned int get_flat_members(PFORMAT_STRING pFormat, ULONG *size)
+{
+  PFORMAT_STRING start = pFormat;
+
+  *size = 0;
+  for (;; pFormat++) {
+    switch (*pFormat) {
+    case FC_BYTE:
+    case FC_CHAR:
+    case FC_SMALL:
+    case FC_USMALL:
+      *size += 1;
+      break;
+    case FC_WCHAR:
+    case FC_SHORT:
+    case FC_USHORT:
+      *size += 2;
+      break;
+    case FC_LONG:
+    case FC_ULONG:
+    case FC_ENUM32:
+    case FC_FLOAT:
+      *size += 4;
+      break;
+    case FC_HYPER:
+    case FC_DOUBLE:
+      *size += 8;
+      break;
+    default:
+      return pFormat - start;
+    }
+  }
+}
+
 static unsigned char * ComplexMarshall(PMIDL_STUB_MESSAGE pStubMsg,
                                        unsigned char *pMemory,
                                        PFORMAT_STRING pFormat,
@@ -2848,8 +2885,16 @@ static unsigned char * ComplexMarshall(PMIDL_STUB_MESSAGE pStubMsg,
   PFORMAT_STRING desc;
   NDR_MARSHALL m;
   ULONG size;
+  unsigned int count;
 
   while (*pFormat != FC_END) {
+    if ((count = get_flat_members(pFormat, &size)) > 1) {
+      TRACE("%u members (size=%d) <= %p\n", count, size, pMemory);
+      safe_copy_to_buffer(pStubMsg, pMemory, size);
+      pMemory += size;
+      pFormat += count;
+      continue;
+    }
     switch (*pFormat) {
     case FC_BYTE:
     case FC_CHAR:
@@ -3008,8 +3053,16 @@ static unsigned char * ComplexUnmarshall(PMIDL_STUB_MESSAGE pStubMsg,
   PFORMAT_STRING desc;
   NDR_UNMARSHALL m;
   ULONG size;
+  unsigned int count;
 
   while (*pFormat != FC_END) {
+    if ((count = get_flat_members(pFormat, &size)) > 1) {
+      safe_copy_from_buffer(pStubMsg, pMemory, size);
+      TRACE("%u members (size=%d) => %p\n", count, size, pMemory);
+      pMemory += size;
+      pFormat += count;
+      continue;
+    }
     switch (*pFormat) {
     case FC_BYTE:
     case FC_CHAR:
@@ -3184,8 +3237,15 @@ static unsigned char * ComplexBufferSize(PMIDL_STUB_MESSAGE pStubMsg,
   PFORMAT_STRING desc;
   NDR_BUFFERSIZE m;
   ULONG size;
+  unsigned int count;
 
   while (*pFormat != FC_END) {
+    if ((count = get_flat_members(pFormat, &size)) > 1) {
+      safe_buffer_length_increment(pStubMsg, size);
+      pMemory += size;
+      pFormat += count;
+      continue;
+    }
     switch (*pFormat) {
     case FC_BYTE:
     case FC_CHAR:
@@ -3406,9 +3466,16 @@ static ULONG ComplexStructMemorySize(PMIDL_STUB_MESSAGE pStubMsg,
                                      PFORMAT_STRING pPointer)
 {
   PFORMAT_STRING desc;
-  ULONG size = 0;
+  ULONG size = 0, flat_size;
+  unsigned int count;
 
   while (*pFormat != FC_END) {
+    if ((count = get_flat_members(pFormat, &flat_size)) > 1) {
+      size += flat_size;
+      safe_buffer_increment(pStubMsg, flat_size);
+      pFormat += count;
+      continue;
+    }
     switch (*pFormat) {
     case FC_BYTE:
     case FC_CHAR:
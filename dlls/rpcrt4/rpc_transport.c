@@ -468,6 +468,94 @@ static int rpcrt4_conn_np_wait_for_incoming_data(RpcConnection *conn)
     return rpcrt4_conn_np_read(conn, NULL, 0);
 }
 
+/* The pipes are in message mode and every fragment is written as a single
+ * message, so read it in one go instead of doing separate reads for the
+ * common header, the rest of the header and the payload. */
+static RPC_STATUS rpcrt4_conn_np_receive_fragment(RpcConnection *conn, RpcPktHdr **Header, void **Payload)
+{
+    RpcPktCommonHdr *common_hdr;
+    RPC_STATUS status;
+    DWORD hdr_length, frag_len;
+    char *buffer, *new_buffer;
+    int count, ret;
+
+    *Header = NULL;
+    *Payload = NULL;
+
+    TRACE("(%p, %p, %p)\n", conn, Header, Payload);
+
+    if (!(buffer = HeapAlloc(GetProcessHeap(), 0, RPC_MAX_PACKET_SIZE)))
+        return RPC_S_OUT_OF_RESOURCES;
+
+    count = rpcrt4_conn_np_read(conn, buffer, RPC_MAX_PACKET_SIZE);
+    if (count < (int)sizeof(*common_hdr))
+    {
+        WARN("Short read of header, %d bytes\n", count);
+        status = RPC_S_CALL_FAILED;
+        goto fail;
+    }
+
+    common_hdr = (RpcPktCommonHdr *)buffer;
+    status = RPCRT4_ValidateCommonHeader(common_hdr);
+    if (status != RPC_S_OK) goto fail;
+
+    hdr_length = RPCRT4_GetHeaderSize((RpcPktHdr *)common_hdr);
+    frag_len = common_hdr->frag_len;
+    if (count > frag_len)
+    {
+        WARN("message longer than fragment, %d/%d\n", count, frag_len);
+        status = RPC_S_PROTOCOL_ERROR;
+        goto fail;
+    }
+
+    /* the message didn't fit in the buffer, fetch the rest of it */
+    if (frag_len > RPC_MAX_PACKET_SIZE)
+    {
+        if (!(new_buffer = HeapReAlloc(GetProcessHeap(), 0, buffer, frag_len)))
+        {
+            status = RPC_S_OUT_OF_RESOURCES;
+            goto fail;
+        }
+        buffer = new_buffer;
+    }
+    while (count < frag_len)
+    {
+        ret = rpcrt4_conn_np_read(conn, buffer + count, frag_len - count);
+        if (ret <= 0)
+        {
+            WARN("bad data length, %d/%d\n", count, frag_len);
+            status = RPC_S_CALL_FAILED;
+            goto fail;
+        }
+        count += ret;
+    }
+
+    if (!(*Header = HeapAlloc(GetProcessHeap(), 0, hdr_length)))
+    {
+        status = RPC_S_OUT_OF_RESOURCES;
+        goto fail;
+    }
+    memcpy(*Header, buffer, hdr_length);
+
+    if (frag_len - hdr_length)
+    {
+        memmove(buffer, buffer + hdr_length, frag_len - hdr_length);
+        *Payload = buffer;
+        buffer = NULL;
+    }
+
+    status = RPC_S_OK;
+
+fail:
+    HeapFree(GetProcessHeap(), 0, buffer);
+    if (status != RPC_S_OK)
+    {
+        RPCRT4_FreeHeader(*Header);
+        *Header = NULL;
+    }
+    return status;
+}
+
 static size_t rpcrt4_ncacn_np_get_top_of_tower(unsigned char *tower_data,
                                                const char *networkaddr,
                                                const char *endpoint)
@@ -3127,7 +3215,7 @@ static const struct connection_ops conn_protseq_list[] = {
     rpcrt4_conn_np_wait_for_incoming_data,
     rpcrt4_ncacn_np_get_top_of_tower,
     rpcrt4_ncacn_np_parse_top_of_tower,
-    NULL,
+    rpcrt4_conn_np_receive_fragment,
     RPCRT4_default_is_authorized,
     RPCRT4_default_authorize,
     RPCRT4_default_secure_packet,
@@ -3149,7 +3237,7 @@ static const struct connection_ops conn_protseq_list[] = {
     rpcrt4_conn_np_wait_for_incoming_data,
     rpcrt4_ncalrpc_get_top_of_tower,
     rpcrt4_ncalrpc_parse_top_of_tower,
-    NULL,
+    rpcrt4_conn_np_receive_fragment,
     rpcrt4_ncalrpc_is_authorized,
     rpcrt4_ncalrpc_authorize,
     rpcrt4_ncalrpc_secure_packet,
@@ -1270,6 +1270,84 @@ static void test_struct_align(void)
     heap_free(memsrc_orig);
 }
 
+struct flat
+{
+    short s;
+    char c1, c2;
+    LONG l;
+    LONGLONG ll;
+    double d;
+};
+
+static void test_struct_flat_members(void)
+{
+    RPC_MESSAGE RpcMessage;
+    MIDL_STUB_MESSAGE StubMsg;
+    MIDL_STUB_DESC StubDesc;
+    struct flat memsrc, *mem;
+    ULONG size;
+    void *ptr;
+
+    /* bogus struct made of base types whose wire layout matches memory */
+    static const unsigned char fmtstr[] =
+    {
+        0x1a,   /* FC_BOGUS_STRUCT */
+        0x7,    /* alignment 8 */
+        NdrFcShort(0x18),   /* memory size 24 */
+        NdrFcShort(0x0),
+        NdrFcShort(0x0),
+        0x06,   /* FC_SHORT */
+        0x02,   /* FC_CHAR */
+        0x01,   /* FC_BYTE */
+        0x08,   /* FC_LONG */
+        0x0b,   /* FC_HYPER */
+        0x0c,   /* FC_DOUBLE */
+        0x5b,   /* FC_END */
+    };
+
+    memsrc.s = 0x1234;
+    memsrc.c1 = 'a';
+    memsrc.c2 = 'b';
+    memsrc.l = 0xdeadbeef;
+    memsrc.ll = ((ULONGLONG) 0xbadefeed << 32) | 0x2468ace0;
+    memsrc.d = 1.5;
+
+    StubDesc = Object_StubDesc;
+    StubDesc.pFormatTypes = fmtstr;
+    NdrClientInitializeNew(&RpcMessage, &StubMsg, &StubDesc, 0);
+
+    StubMsg.BufferLength = 0;
+    NdrComplexStructBufferSize(&StubMsg, (unsigned char *)&memsrc, fmtstr);
+    ok(StubMsg.BufferLength == sizeof(memsrc), "length %u\n", StubMsg.BufferLength);
+
+    StubMsg.RpcMsg->Buffer = StubMsg.BufferStart = StubMsg.Buffer = heap_alloc(StubMsg.BufferLength);
+    StubMsg.BufferEnd = StubMsg.BufferStart + StubMsg.BufferLength;
+
+    ptr = NdrComplexStructMarshall(&StubMsg, (unsigned char *)&memsrc, fmtstr);
+    ok(ptr == NULL, "ret %p\n", ptr);
+    ok(StubMsg.Buffer - StubMsg.BufferStart == sizeof(memsrc), "length %u\n",
+       (ULONG)(StubMsg.Buffer - StubMsg.BufferStart));
+    ok(!memcmp(StubMsg.BufferStart, &memsrc, sizeof(memsrc)), "struct wasn't marshalled correctly\n");
+
+    StubMsg.Buffer = StubMsg.BufferStart;
+    StubMsg.MemorySize = 0;
+    size = NdrComplexStructMemorySize(&StubMsg, fmtstr);
+    ok(size == sizeof(memsrc), "size %u\n", size);
+    ok(StubMsg.Buffer - StubMsg.BufferStart == sizeof(memsrc), "length %u\n",
+       (ULONG)(StubMsg.Buffer - StubMsg.BufferStart));
+
+    /* Server */
+    StubMsg.IsClient = 0;
+    mem = NULL;
+    StubMsg.Buffer = StubMsg.BufferStart;
+    ptr = NdrComplexStructUnmarshall(&StubMsg, (unsigned char **)&mem, fmtstr, 0);
+    ok(ptr == NULL, "ret %p\n", ptr);
+    ok(!memcmp(mem, &memsrc, sizeof(memsrc)), "struct wasn't unmarshalled correctly\n");
+    StubMsg.pfnFree(mem);
+
+    heap_free(StubMsg.RpcMsg->Buffer);
+}
+
 struct testiface
 {
     IPersist IPersist_iface;
@@ -3009,6 +3087,7 @@ START_TEST( ndr_marshall )
     test_nontrivial_pointer_types();
     test_simple_struct();
     test_struct_align();
+    test_struct_flat_members();
     test_iface_ptr();
     test_fullpointer_xlat();
     test_client_init();
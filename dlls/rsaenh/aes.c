@@ -1061,18 +1061,19 @@ int aes_setup(const unsigned char *key, int keylen, int rounds, aes_key *skey)
     return CRYPT_OK;
 }
 
-void aes_ecb_encrypt(const unsigned char *pt, unsigned char *ct, aes_key *skey)
+static inline void aes_encrypt_words(ulong32 *s, const aes_key *skey)
 {
-    ulong32 s0, s1, s2, s3, t0, t1, t2, t3, *rk;
+    ulong32 s0, s1, s2, s3, t0, t1, t2, t3;
+    const ulong32 *rk;
     int Nr, r;
 
     Nr = skey->Nr;
     rk = skey->eK;
 
-    LOAD32H(s0, pt      ); s0 ^= rk[0];
-    LOAD32H(s1, pt  +  4); s1 ^= rk[1];
-    LOAD32H(s2, pt  +  8); s2 ^= rk[2];
-    LOAD32H(s3, pt  + 12); s3 ^= rk[3];
+    s0 = s[0] ^ rk[0];
+    s1 = s[1] ^ rk[1];
+    s2 = s[2] ^ rk[2];
+    s3 = s[3] ^ rk[3];
 
     r = Nr >> 1;
     for (;;) {
@@ -1138,42 +1139,54 @@ void aes_ecb_encrypt(const unsigned char *pt, unsigned char *ct, aes_key *skey)
         (Te4_1[byte(t2, 1)]) ^
         (Te4_0[byte(t3, 0)]) ^
         rk[0];
-    STORE32H(s0, ct);
+    s[0] = s0;
     s1 =
         (Te4_3[byte(t1, 3)]) ^
         (Te4_2[byte(t2, 2)]) ^
         (Te4_1[byte(t3, 1)]) ^
         (Te4_0[byte(t0, 0)]) ^
         rk[1];
-    STORE32H(s1, ct+4);
+    s[1] = s1;
     s2 =
         (Te4_3[byte(t2, 3)]) ^
         (Te4_2[byte(t3, 2)]) ^
         (Te4_1[byte(t0, 1)]) ^
         (Te4_0[byte(t1, 0)]) ^
         rk[2];
-    STORE32H(s2, ct+8);
+    s[2] = s2;
     s3 =
         (Te4_3[byte(t3, 3)]) ^
         (Te4_2[byte(t0, 2)]) ^
         (Te4_1[byte(t1, 1)]) ^
         (Te4_0[byte(t2, 0)]) ^
         rk[3];
-    STORE32H(s3, ct+12);
+    s[3] = s3;
 }
 
-void aes_ecb_decrypt(const unsigned char *ct, unsigned char *pt, aes_key *skey)
+void aes_ecb_encrypt(const unsigned char *pt, unsigned char *ct, aes_key *skey)
+{
+    ulong32 s[4];
+
+    LOAD32H(s[0], pt     ); LOAD32H(s[1], pt +  4);
+    LOAD32H(s[2], pt +  8); LOAD32H(s[3], pt + 12);
+    aes_encrypt_words(s, skey);
+    STORE32H(s[0], ct     ); STORE32H(s[1], ct +  4);
+    STORE32H(s[2], ct +  8); STORE32H(s[3], ct + 12);
+}
+
+static inline void aes_decrypt_words(ulong32 *s, const aes_key *skey)
 {
-    ulong32 s0, s1, s2, s3, t0, t1, t2, t3, *rk;
+    ulong32 s0, s1, s2, s3, t0, t1, t2, t3;
+    const ulong32 *rk;
     int Nr, r;
 
     Nr = skey->Nr;
     rk = skey->dK;
 
-    LOAD32H(s0, ct      ); s0 ^= rk[0];
-    LOAD32H(s1, ct  +  4); s1 ^= rk[1];
-    LOAD32H(s2, ct  +  8); s2 ^= rk[2];
-    LOAD32H(s3, ct  + 12); s3 ^= rk[3];
+    s0 = s[0] ^ rk[0];
+    s1 = s[1] ^ rk[1];
+    s2 = s[2] ^ rk[2];
+    s3 = s[3] ^ rk[3];
 
     r = Nr >> 1;
     for (;;) {
@@ -1241,26 +1254,88 @@ void aes_ecb_decrypt(const unsigned char *ct, unsigned char *pt, aes_key *skey)
         (Td4[byte(t2, 1)] & 0x0000ff00) ^
         (Td4[byte(t1, 0)] & 0x000000ff) ^
         rk[0];
-    STORE32H(s0, pt);
+    s[0] = s0;
     s1 =
         (Td4[byte(t1, 3)] & 0xff000000) ^
         (Td4[byte(t0, 2)] & 0x00ff0000) ^
         (Td4[byte(t3, 1)] & 0x0000ff00) ^
         (Td4[byte(t2, 0)] & 0x000000ff) ^
         rk[1];
-    STORE32H(s1, pt+4);
+    s[1] = s1;
     s2 =
         (Td4[byte(t2, 3)] & 0xff000000) ^
         (Td4[byte(t1, 2)] & 0x00ff0000) ^
         (Td4[byte(t0, 1)] & 0x0000ff00) ^
         (Td4[byte(t3, 0)] & 0x000000ff) ^
         rk[2];
-    STORE32H(s2, pt+8);
+    s[2] = s2;
     s3 =
         (Td4[byte(t3, 3)] & 0xff000000) ^
         (Td4[byte(t2, 2)] & 0x00ff0000) ^
         (Td4[byte(t1, 1)] & 0x0000ff00) ^
         (Td4[byte(t0, 0)] & 0x000000ff) ^
         rk[3];
-    STORE32H(s3, pt+12);
+    s[3] = s3;
+}
+
+void aes_ecb_decrypt(const unsigned char *ct, unsigned char *pt, aes_key *skey)
+{
+    ulong32 s[4];
+
+    LOAD32H(s[0], ct     ); LOAD32H(s[1], ct +  4);
+    LOAD32H(s[2], ct +  8); LOAD32H(s[3], ct + 12);
+    aes_decrypt_words(s, skey);
+    STORE32H(s[0], pt     ); STORE32H(s[1], pt +  4);
+    STORE32H(s[2], pt +  8); STORE32H(s[3], pt + 12);
+}
+
+/* Encrypts len bytes of data in place in CBC mode; len must be a multiple of
+ * the block size.  The chaining value is kept in host order between blocks
+ * and written back to iv when done. */
+void aes_cbc_encrypt(unsigned char *data, unsigned long len, unsigned char *iv, aes_key *skey)
+{
+    ulong32 s[4], p;
+    int i;
+
+    LOAD32H(s[0], iv     ); LOAD32H(s[1], iv +  4);
+    LOAD32H(s[2], iv +  8); LOAD32H(s[3], iv + 12);
+    for (; len >= 16; len -= 16, data += 16)
+    {
+        for (i = 0; i < 4; i++)
+        {
+            LOAD32H(p, data + 4 * i);
+            s[i] ^= p;
+        }
+        aes_encrypt_words(s, skey);
+        for (i = 0; i < 4; i++) STORE32H(s[i], data + 4 * i);
+    }
+    STORE32H(s[0], iv     ); STORE32H(s[1], iv +  4);
+    STORE32H(s[2], iv +  8); STORE32H(s[3], iv + 12);
+}
+
+/* Decrypts len bytes of data in place in CBC mode. */
+void aes_cbc_decrypt(unsigned char *data, unsigned long len, unsigned char *iv, aes_key *skey)
+{
+    ulong32 s[4], c[4], prev[4];
+    int i;
+
+    LOAD32H(prev[0], iv     ); LOAD32H(prev[1], iv +  4);
+    LOAD32H(prev[2], iv +  8); LOAD32H(prev[3], iv + 12);
+    for (; len >= 16; len -= 16, data += 16)
+    {
+        for (i = 0; i < 4; i++)
+        {
+            LOAD32H(c[i], data + 4 * i);
+            s[i] = c[i];
+        }
+        aes_decrypt_words(s, skey);
+        for (i = 0; i < 4; i++)
+        {
+            s[i] ^= prev[i];
+            STORE32H(s[i], data + 4 * i);
+            prev[i] = c[i];
+        }
+    }
+    STORE32H(prev[0], iv     ); STORE32H(prev[1], iv +  4);
+    STORE32H(prev[2], iv +  8); STORE32H(prev[3], iv + 12);
 }
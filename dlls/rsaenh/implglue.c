@@ -298,6 +298,39 @@ BOOL encrypt_block_impl(ALG_ID aiAlgid, DWORD dwKeySpec, KEY_CONTEXT *pKeyContex
     return TRUE;
 }
 
+BOOL encrypt_blocks_impl(ALG_ID aiAlgid, DWORD dwMode, KEY_CONTEXT *pKeyContext, BYTE *pbInOut,
+                         DWORD dwLen, BYTE *pbChainVector, DWORD enc)
+{
+    DWORD i;
+
+    switch (aiAlgid) {
+        case CALG_AES:
+        case CALG_AES_128:
+        case CALG_AES_192:
+        case CALG_AES_256:
+            switch (dwMode) {
+                case CRYPT_MODE_ECB:
+                    for (i = 0; i < dwLen; i += 16) {
+                        if (enc)
+                            aes_ecb_encrypt(pbInOut + i, pbInOut + i, &pKeyContext->aes);
+                        else
+                            aes_ecb_decrypt(pbInOut + i, pbInOut + i, &pKeyContext->aes);
+                    }
+                    return TRUE;
+
+                case CRYPT_MODE_CBC:
+                    if (enc)
+                        aes_cbc_encrypt(pbInOut, dwLen, pbChainVector, &pKeyContext->aes);
+                    else
+                        aes_cbc_decrypt(pbInOut, dwLen, pbChainVector, &pKeyContext->aes);
+                    return TRUE;
+            }
+            break;
+    }
+
+    return FALSE;
+}
+
 BOOL encrypt_stream_impl(ALG_ID aiAlgid, KEY_CONTEXT *pKeyContext, BYTE *stream, DWORD dwLen)
 {
     switch (aiAlgid) {
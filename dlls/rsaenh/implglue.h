@@ -55,6 +55,9 @@ BOOL duplicate_key_impl(ALG_ID aiAlgid, const KEY_CONTEXT *pSrcKeyContext,
 /* dwKeySpec is optional for symmetric key algorithms */
 BOOL encrypt_block_impl(ALG_ID aiAlgid, DWORD dwKeySpec, KEY_CONTEXT *pKeyContext, const BYTE *pbIn,
                         BYTE *pbOut, DWORD enc) DECLSPEC_HIDDEN;
+/* Returns FALSE if the algorithm and mode have no multi-block implementation */
+BOOL encrypt_blocks_impl(ALG_ID aiAlgid, DWORD dwMode, KEY_CONTEXT *pKeyContext, BYTE *pbInOut,
+                         DWORD dwLen, BYTE *pbChainVector, DWORD enc) DECLSPEC_HIDDEN;
 BOOL encrypt_stream_impl(ALG_ID aiAlgid, KEY_CONTEXT *pKeyContext, BYTE *pbInOut, DWORD dwLen) DECLSPEC_HIDDEN;
 
 BOOL export_public_key_impl(BYTE *pbDest, const KEY_CONTEXT *pKeyContext, DWORD dwKeyLen,
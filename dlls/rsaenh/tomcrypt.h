@@ -149,6 +149,8 @@ void des3_ecb_decrypt(const unsigned char *ct, unsigned char *pt, const des3_key
 int aes_setup(const unsigned char *key, int keylen, int rounds, aes_key *skey);
 void aes_ecb_encrypt(const unsigned char *pt, unsigned char *ct, aes_key *skey);
 void aes_ecb_decrypt(const unsigned char *ct, unsigned char *pt, aes_key *skey);
+void aes_cbc_encrypt(unsigned char *data, unsigned long len, unsigned char *iv, aes_key *skey);
+void aes_cbc_decrypt(unsigned char *data, unsigned long len, unsigned char *iv, aes_key *skey);
 
 struct rc4_prng {
     int x, y;
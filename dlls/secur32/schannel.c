@@ -75,6 +75,9 @@ static SIZE_T schan_handle_count;
 /* Protocols enabled, only those may be used for the connection. */
 static DWORD config_enabled_protocols;
 
+/* How long client sessions are kept for resumption, in seconds. */
+static DWORD config_client_cache_time = 36000;
+
 /* Protocols disabled by default. They are enabled for using, but disabled when caller asks for default settings. */
 static DWORD config_default_disabled_protocols;
 
@@ -235,11 +238,24 @@ static void read_config(void)
 
     RegCloseKey(protocols_key);
 
+    res = RegOpenKeyExW(HKEY_LOCAL_MACHINE, L"SYSTEM\\CurrentControlSet\\Control\\SecurityProviders\\SCHANNEL",
+                        0, KEY_READ, &key);
+    if(res == ERROR_SUCCESS) {
+        DWORD type, size = sizeof(DWORD), value;
+
+        /* ClientCacheTime is in milliseconds */
+        res = RegQueryValueExW(key, L"ClientCacheTime", NULL, &type, (BYTE *)&value, &size);
+        if(res == ERROR_SUCCESS && type == REG_DWORD)
+            config_client_cache_time = value / 1000;
+        RegCloseKey(key);
+    }
+
     config_enabled_protocols = enabled & GNUTLS_CALL( get_enabled_protocols, NULL );
     config_default_disabled_protocols = default_disabled;
     config_read = TRUE;
 
-    TRACE("enabled %lx, disabled by default %lx\n", config_enabled_protocols, config_default_disabled_protocols);
+    TRACE("enabled %lx, disabled by default %lx, client cache time %lu\n", config_enabled_protocols,
+          config_default_disabled_protocols, config_client_cache_time);
 }
 
 static SECURITY_STATUS schan_QueryCredentialsAttributes(
@@ -537,6 +553,37 @@ static BYTE *get_key_blob(const CERT_CONTEXT *ctx, DWORD *size)
     return ret;
 }
 
+static DWORD get_session_cache_time(const void *credentials)
+{
+    const SCHANNEL_CRED *cred_old;
+    const SCH_CREDENTIALS *cred = credentials;
+    DWORD lifespan, flags;
+
+    if (!cred) return config_client_cache_time;
+
+    switch (cred->dwVersion)
+    {
+    case SCH_CRED_V3:
+    case SCHANNEL_CRED_VERSION:
+        cred_old = credentials;
+        lifespan = cred_old->dwSessionLifespan;
+        flags = cred_old->dwFlags;
+        break;
+
+    case SCH_CREDENTIALS_VERSION:
+        lifespan = cred->dwSessionLifespan;
+        flags = cred->dwFlags;
+        break;
+
+    default:
+        return config_client_cache_time;
+    }
+
+    if (flags & SCH_CRED_DISABLE_RECONNECTS) return 0;
+    /* dwSessionLifespan is in milliseconds, 0 selects the default */
+    return lifespan ? max(lifespan / 1000, 1) : config_client_cache_time;
+}
+
 static SECURITY_STATUS schan_AcquireClientCredentials(const void *schanCred,
  PCredHandle phCredential, PTimeStamp ptsExpiry)
 {
@@ -580,6 +627,7 @@ static SECURITY_STATUS schan_AcquireClientCredentials(const void *schanCred,
     if (!(creds = malloc(sizeof(*creds)))) return SEC_E_INSUFFICIENT_MEMORY;
     creds->credential_use = SECPKG_CRED_OUTBOUND;
     creds->enabled_protocols = enabled_protocols;
+    creds->cache_time = get_session_cache_time(schanCred);
 
     if (cert && !(key_blob.pbData = get_key_blob(cert, &key_blob.cbData))) goto fail;
     params.c = creds;
@@ -836,7 +884,7 @@ static SECURITY_STATUS SEC_ENTRY schan_InitializeSecurityContextW(
 
             if (target)
             {
-                struct set_session_target_params params = { ctx->transport.session, target };
+                struct set_session_target_params params = { ctx->transport.session, target, cred->cache_time };
                 WideCharToMultiByte( CP_UNIXCP, 0, pszTargetName, -1, target, len, NULL, NULL );
                 GNUTLS_CALL( set_session_target, &params );
                 free( target );
@@ -1145,6 +1193,12 @@ static SECURITY_STATUS SEC_ENTRY schan_QueryContextAttributesW(
             struct get_connection_info_params params = { ctx->transport.session, info };
             return GNUTLS_CALL( get_connection_info, &params );
         }
+        case SECPKG_ATTR_SESSION_INFO:
+        {
+            SecPkgContext_SessionInfo *info = buffer;
+            struct get_session_info_params params = { ctx->transport.session, info };
+            return GNUTLS_CALL( get_session_info, &params );
+        }
         case SECPKG_ATTR_ENDPOINT_BINDINGS:
         {
             SecPkgContext_Bindings *bindings = buffer;
@@ -1250,6 +1304,8 @@ static SECURITY_STATUS SEC_ENTRY schan_QueryContextAttributesA(
             return schan_QueryContextAttributesW(context_handle, attribute, buffer);
         case SECPKG_ATTR_CONNECTION_INFO:
             return schan_QueryContextAttributesW(context_handle, attribute, buffer);
+        case SECPKG_ATTR_SESSION_INFO:
+            return schan_QueryContextAttributesW(context_handle, attribute, buffer);
         case SECPKG_ATTR_ENDPOINT_BINDINGS:
             return schan_QueryContextAttributesW(context_handle, attribute, buffer);
         case SECPKG_ATTR_UNIQUE_BINDINGS:
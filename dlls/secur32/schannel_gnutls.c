@@ -29,6 +29,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <pthread.h>
+#include <time.h>
 #include <sys/types.h>
 #include <dlfcn.h>
 #ifdef SONAME_LIBGNUTLS
@@ -46,6 +48,7 @@
 #include "secur32_priv.h"
 
 #include "wine/unixlib.h"
+#include "wine/list.h"
 #include "wine/debug.h"
 
 #if defined(SONAME_LIBGNUTLS)
@@ -77,6 +80,9 @@ static int (*pgnutls_privkey_import_rsa_raw)(gnutls_privkey_t, const gnutls_datu
 /* Not present in gnutls version < 3.4.0. */
 static int (*pgnutls_privkey_export_x509)(gnutls_privkey_t, gnutls_x509_privkey_t *);
 
+/* Not present in gnutls version < 3.5.0. */
+static unsigned int (*pgnutls_session_get_flags)(gnutls_session_t);
+
 static void *libgnutls_handle;
 #define MAKE_FUNCPTR(f) static typeof(f) * p##f
 MAKE_FUNCPTR(gnutls_alert_get);
@@ -108,6 +114,12 @@ MAKE_FUNCPTR(gnutls_record_recv);
 MAKE_FUNCPTR(gnutls_record_send);
 MAKE_FUNCPTR(gnutls_server_name_set);
 MAKE_FUNCPTR(gnutls_session_channel_binding);
+MAKE_FUNCPTR(gnutls_session_get_data);
+MAKE_FUNCPTR(gnutls_session_get_id);
+MAKE_FUNCPTR(gnutls_session_get_ptr);
+MAKE_FUNCPTR(gnutls_session_is_resumed);
+MAKE_FUNCPTR(gnutls_session_set_data);
+MAKE_FUNCPTR(gnutls_session_set_ptr);
 MAKE_FUNCPTR(gnutls_transport_get_ptr);
 MAKE_FUNCPTR(gnutls_transport_set_errno);
 MAKE_FUNCPTR(gnutls_transport_set_ptr);
@@ -136,6 +148,10 @@ MAKE_FUNCPTR(gnutls_x509_privkey_deinit);
 #define GNUTLS_ALPN_SERVER_PRECEDENCE (1<<1)
 #endif
 
+#if GNUTLS_VERSION_NUMBER < 0x030603
+#define GNUTLS_SFLAGS_SESSION_TICKET (1<<7)
+#endif
+
 static int compat_cipher_get_block_size(gnutls_cipher_algorithm_t cipher)
 {
     switch(cipher) {
@@ -194,6 +210,11 @@ static int compat_gnutls_alpn_set_protocols(gnutls_session_t session, const gnut
     return GNUTLS_E_INVALID_REQUEST;
 }
 
+static unsigned int compat_gnutls_session_get_flags(gnutls_session_t session)
+{
+    return 0;
+}
+
 static void compat_gnutls_dtls_set_mtu(gnutls_session_t session, unsigned int mtu)
 {
     FIXME("\n");
@@ -473,6 +494,130 @@ static int pull_timeout(gnutls_transport_ptr_t transport, unsigned int timeout)
     return -1;
 }
 
+/* Client sessions are kept for resumption, keyed by target name and credentials. */
+struct session_cache_entry
+{
+    struct list entry;
+    schan_credentials *cred;
+    char *target;
+    void *data;
+    size_t size;
+    time_t expires;
+};
+
+struct session_info
+{
+    schan_credentials *cred;
+    char *target;
+    unsigned int cache_time;
+    BOOL ticket_stored;
+};
+
+#define MAX_CACHED_SESSIONS 256
+
+static pthread_mutex_t session_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct list session_cache = LIST_INIT( session_cache );
+static unsigned int session_cache_count;
+
+static void free_session_cache_entry( struct session_cache_entry *entry )
+{
+    list_remove( &entry->entry );
+    session_cache_count--;
+    free( entry->target );
+    free( entry->data );
+    free( entry );
+}
+
+/* Must be called with session_cache_mutex held. */
+static struct session_cache_entry *find_cached_session( schan_credentials *cred, const char *target )
+{
+    struct session_cache_entry *entry, *next;
+    time_t now = time( NULL );
+
+    LIST_FOR_EACH_ENTRY_SAFE( entry, next, &session_cache, struct session_cache_entry, entry )
+    {
+        if (entry->expires <= now)
+        {
+            free_session_cache_entry( entry );
+            continue;
+        }
+        if (entry->cred == cred && !strcmp( entry->target, target )) return entry;
+    }
+    return NULL;
+}
+
+static void resume_cached_session( gnutls_session_t s, const struct session_info *info )
+{
+    struct session_cache_entry *entry;
+    int err;
+
+    pthread_mutex_lock( &session_cache_mutex );
+    if ((entry = find_cached_session( info->cred, info->target )))
+    {
+        TRACE( "resuming session for %s\n", debugstr_a(info->target) );
+        if ((err = pgnutls_session_set_data( s, entry->data, entry->size )) != GNUTLS_E_SUCCESS)
+        {
+            pgnutls_perror( err );
+            free_session_cache_entry( entry );
+        }
+    }
+    pthread_mutex_unlock( &session_cache_mutex );
+}
+
+static void cache_session( gnutls_session_t s, const struct session_info *info )
+{
+    struct session_cache_entry *entry;
+    size_t size = 0;
+    void *data;
+
+    if (pgnutls_session_get_data( s, NULL, &size ) != GNUTLS_E_SUCCESS || !size) return;
+    if (!(data = malloc( size ))) return;
+    if (pgnutls_session_get_data( s, data, &size ) != GNUTLS_E_SUCCESS)
+    {
+        free( data );
+        return;
+    }
+
+    pthread_mutex_lock( &session_cache_mutex );
+    if ((entry = find_cached_session( info->cred, info->target )))
+    {
+        list_remove( &entry->entry );
+        free( entry->data );
+    }
+    else if ((entry = malloc( sizeof(*entry) )) && (entry->target = strdup( info->target )))
+    {
+        entry->cred = info->cred;
+        session_cache_count++;
+    }
+    else
+    {
+        free( entry );
+        free( data );
+        pthread_mutex_unlock( &session_cache_mutex );
+        return;
+    }
+    entry->data = data;
+    entry->size = size;
+    entry->expires = time( NULL ) + info->cache_time;
+    list_add_head( &session_cache, &entry->entry );
+
+    while (session_cache_count > MAX_CACHED_SESSIONS)
+        free_session_cache_entry( LIST_ENTRY( list_tail( &session_cache ), struct session_cache_entry, entry ) );
+    pthread_mutex_unlock( &session_cache_mutex );
+
+    TRACE( "cached session for %s\n", debugstr_a(info->target) );
+}
+
+static void purge_cached_sessions( schan_credentials *cred )
+{
+    struct session_cache_entry *entry, *next;
+
+    pthread_mutex_lock( &session_cache_mutex );
+    LIST_FOR_EACH_ENTRY_SAFE( entry, next, &session_cache, struct session_cache_entry, entry )
+        if (entry->cred == cred) free_session_cache_entry( entry );
+    pthread_mutex_unlock( &session_cache_mutex );
+}
+
 static NTSTATUS schan_create_session( void *args )
 {
     const struct create_session_params *params = args;
@@ -543,6 +688,17 @@ static NTSTATUS schan_create_session( void *args )
     pgnutls_transport_set_push_function(*s, push_adapter);
     pgnutls_transport_set_ptr(*s, (gnutls_transport_ptr_t)params->transport);
 
+    if (flags & GNUTLS_CLIENT)
+    {
+        struct session_info *info;
+
+        if ((info = calloc(1, sizeof(*info))))
+        {
+            info->cred = cred;
+            pgnutls_session_set_ptr(*s, info);
+        }
+    }
+
     return STATUS_SUCCESS;
 }
 
@@ -550,6 +706,13 @@ static NTSTATUS schan_dispose_session( void *args )
 {
     const struct session_params *params = args;
     gnutls_session_t s = (gnutls_session_t)params->session;
+    struct session_info *info = pgnutls_session_get_ptr(s);
+
+    if (info)
+    {
+        free(info->target);
+        free(info);
+    }
     pgnutls_deinit(s);
     return STATUS_SUCCESS;
 }
@@ -558,7 +721,15 @@ static NTSTATUS schan_set_session_target( void *args )
 {
     const struct set_session_target_params *params = args;
     gnutls_session_t s = (gnutls_session_t)params->session;
+    struct session_info *info = pgnutls_session_get_ptr( s );
+
     pgnutls_server_name_set( s, GNUTLS_NAME_DNS, params->target, strlen(params->target) );
+
+    if (info && params->cache_time && !info->target && (info->target = strdup( params->target )))
+    {
+        info->cache_time = params->cache_time;
+        resume_cached_session( s, info );
+    }
     return STATUS_SUCCESS;
 }
 
@@ -578,8 +749,14 @@ static NTSTATUS schan_handshake( void *args )
         err = pgnutls_handshake(s);
         switch(err) {
         case GNUTLS_E_SUCCESS:
-            TRACE("Handshake completed\n");
+        {
+            struct session_info *info = pgnutls_session_get_ptr(s);
+
+            TRACE("Handshake completed, resumed %d\n", pgnutls_session_is_resumed(s));
+            /* TLS 1.3 tickets arrive after the handshake, they are cached from schan_recv() */
+            if (info && info->target && !pgnutls_session_is_resumed(s)) cache_session(s, info);
             return SEC_E_OK;
+        }
 
         case GNUTLS_E_AGAIN:
             TRACE("Continue...\n");
@@ -901,6 +1078,18 @@ static NTSTATUS schan_recv( void *args )
         }
     }
 
+    if (received)
+    {
+        struct session_info *info = pgnutls_session_get_ptr(s);
+
+        if (info && info->target && !info->ticket_stored &&
+            (pgnutls_session_get_flags(s) & GNUTLS_SFLAGS_SESSION_TICKET))
+        {
+            cache_session(s, info);
+            info->ticket_stored = TRUE;
+        }
+    }
+
     *params->length = received;
     return status;
 }
@@ -988,6 +1177,22 @@ static NTSTATUS schan_get_application_protocol( void *args )
     return SEC_E_OK;
 }
 
+static NTSTATUS schan_get_session_info( void *args )
+{
+    const struct get_session_info_params *params = args;
+    gnutls_session_t s = (gnutls_session_t)params->session;
+    SecPkgContext_SessionInfo *info = params->info;
+    size_t size = sizeof(info->rgbSessionId);
+
+    memset(info, 0, sizeof(*info));
+    if (pgnutls_session_is_resumed(s)) info->dwFlags |= SSL_SESSION_RECONNECT;
+    if (pgnutls_session_get_id(s, info->rgbSessionId, &size) == GNUTLS_E_SUCCESS)
+        info->cbSessionId = size;
+
+    TRACE("flags %#x, session id size %u\n", (unsigned)info->dwFlags, (unsigned)info->cbSessionId);
+    return SEC_E_OK;
+}
+
 static NTSTATUS schan_set_dtls_mtu( void *args )
 {
     const struct set_dtls_mtu_params *params = args;
@@ -1160,6 +1365,7 @@ static NTSTATUS schan_allocate_certificate_credentials( void *args )
 static NTSTATUS schan_free_certificate_credentials( void *args )
 {
     const struct free_certificate_credentials_params *params = args;
+    purge_cached_sessions(params->c);
     pgnutls_certificate_free_credentials(params->c->credentials);
     return STATUS_SUCCESS;
 }
@@ -1227,6 +1433,12 @@ static NTSTATUS process_attach( void *args )
     LOAD_FUNCPTR(gnutls_record_send);
     LOAD_FUNCPTR(gnutls_server_name_set)
     LOAD_FUNCPTR(gnutls_session_channel_binding)
+    LOAD_FUNCPTR(gnutls_session_get_data)
+    LOAD_FUNCPTR(gnutls_session_get_id)
+    LOAD_FUNCPTR(gnutls_session_get_ptr)
+    LOAD_FUNCPTR(gnutls_session_is_resumed)
+    LOAD_FUNCPTR(gnutls_session_set_data)
+    LOAD_FUNCPTR(gnutls_session_set_ptr)
     LOAD_FUNCPTR(gnutls_transport_get_ptr)
     LOAD_FUNCPTR(gnutls_transport_set_errno)
     LOAD_FUNCPTR(gnutls_transport_set_ptr)
@@ -1258,6 +1470,11 @@ static NTSTATUS process_attach( void *args )
         WARN("gnutls_alpn_get_selected_protocol not found\n");
         pgnutls_alpn_get_selected_protocol = compat_gnutls_alpn_get_selected_protocol;
     }
+    if (!(pgnutls_session_get_flags = dlsym(libgnutls_handle, "gnutls_session_get_flags")))
+    {
+        WARN("gnutls_session_get_flags not found\n");
+        pgnutls_session_get_flags = compat_gnutls_session_get_flags;
+    }
     if (!(pgnutls_dtls_set_mtu = dlsym(libgnutls_handle, "gnutls_dtls_set_mtu")))
     {
         WARN("gnutls_dtls_set_mtu not found\n");
@@ -1323,6 +1540,7 @@ const unixlib_entry_t __wine_unix_call_funcs[] =
     schan_get_key_signature_algorithm,
     schan_get_max_message_size,
     schan_get_session_cipher_block_size,
+    schan_get_session_info,
     schan_get_session_peer_certificate,
     schan_get_unique_channel_binding,
     schan_handshake,
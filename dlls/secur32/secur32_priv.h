@@ -86,6 +86,7 @@ typedef struct schan_credentials
     ULONG credential_use;
     void *credentials;
     DWORD enabled_protocols;
+    DWORD cache_time; /* seconds to keep client sessions for resumption */
 } schan_credentials;
 
 struct schan_transport;
@@ -143,6 +144,12 @@ struct get_connection_info_params
     SecPkgContext_ConnectionInfo *info;
 };
 
+struct get_session_info_params
+{
+    schan_session session;
+    SecPkgContext_SessionInfo *info;
+};
+
 struct get_session_peer_certificate_params
 {
     schan_session session;
@@ -201,6 +208,7 @@ struct set_session_target_params
 {
     schan_session session;
     const char *target;
+    unsigned int cache_time; /* seconds to keep the session for resumption */
 };
 
 struct set_dtls_timeouts_params
@@ -224,6 +232,7 @@ enum schan_funcs
     unix_get_key_signature_algorithm,
     unix_get_max_message_size,
     unix_get_session_cipher_block_size,
+    unix_get_session_info,
     unix_get_session_peer_certificate,
     unix_get_unique_channel_binding,
     unix_handshake,
@@ -1613,6 +1613,108 @@ static void test_application_protocol_negotiation(void)
     closesocket(sock);
 }
 
+static SECURITY_STATUS do_client_handshake(SOCKET sock, CredHandle *cred_handle, const char *target,
+                                           CtxtHandle *context)
+{
+    SECURITY_STATUS status;
+    SecBufferDesc buffers[2];
+    SecBuffer *buf;
+    unsigned buf_size = 8192;
+    ULONG attrs;
+
+    init_buffers(&buffers[0], 4, buf_size);
+    init_buffers(&buffers[1], 4, buf_size);
+
+    buffers[0].pBuffers[0].BufferType = SECBUFFER_TOKEN;
+    status = InitializeSecurityContextA(cred_handle, NULL, (SEC_CHAR *)target,
+        ISC_REQ_CONFIDENTIALITY|ISC_REQ_STREAM, 0, 0, NULL, 0, context, &buffers[0], &attrs, NULL);
+    ok(status == SEC_I_CONTINUE_NEEDED, "got %08x\n", status);
+
+    while (status == SEC_I_CONTINUE_NEEDED)
+    {
+        buf = &buffers[0].pBuffers[0];
+        send(sock, buf->pvBuffer, buf->cbBuffer, 0);
+        buf->cbBuffer = buf_size;
+
+        buf = &buffers[1].pBuffers[0];
+        buf->cbBuffer = buf_size;
+        if (receive_data(sock, buf) == -1)
+        {
+            status = SEC_E_INTERNAL_ERROR;
+            break;
+        }
+
+        buf->BufferType = SECBUFFER_TOKEN;
+        status = InitializeSecurityContextA(cred_handle, context, (SEC_CHAR *)target,
+            ISC_REQ_CONFIDENTIALITY|ISC_REQ_STREAM, 0, 0, &buffers[1], 0, NULL, &buffers[0], &attrs, NULL);
+    }
+
+    free_buffers(&buffers[0]);
+    free_buffers(&buffers[1]);
+    return status;
+}
+
+static void test_session_reconnect(void)
+{
+    SOCKET sock;
+    SECURITY_STATUS status;
+    SCHANNEL_CRED cred;
+    CredHandle cred_handle;
+    CtxtHandle context;
+    SecPkgContext_SessionInfo info;
+
+    if (!pQueryContextAttributesA)
+    {
+        win_skip("Required secur32 functions not available\n");
+        return;
+    }
+
+    init_cred(&cred);
+    cred.grbitEnabledProtocols = SP_PROT_TLS1_2_CLIENT;
+    cred.dwFlags = SCH_CRED_NO_DEFAULT_CREDS|SCH_CRED_MANUAL_CRED_VALIDATION;
+
+    status = AcquireCredentialsHandleA(NULL, (SEC_CHAR *)UNISP_NAME_A, SECPKG_CRED_OUTBOUND, NULL,
+        &cred, NULL, NULL, &cred_handle, NULL);
+    ok(status == SEC_E_OK, "got %08x\n", status);
+    if (status != SEC_E_OK) return;
+
+    if ((sock = create_ssl_socket( "test.winehq.org" )) == -1) goto done;
+    status = do_client_handshake(sock, &cred_handle, "test.winehq.org", &context);
+    closesocket(sock);
+    if (status != SEC_E_OK)
+    {
+        skip("Handshake failed\n");
+        goto done;
+    }
+
+    memset(&info, 0xcc, sizeof(info));
+    status = pQueryContextAttributesA(&context, SECPKG_ATTR_SESSION_INFO, &info);
+    ok(status == SEC_E_OK, "got %08x\n", status);
+    ok(!(info.dwFlags & SSL_SESSION_RECONNECT), "got flags %#x\n", info.dwFlags);
+    ok(info.cbSessionId <= sizeof(info.rgbSessionId), "got session id size %u\n", info.cbSessionId);
+    DeleteSecurityContext(&context);
+
+    /* a second connection to the same target should resume the cached session */
+    if ((sock = create_ssl_socket( "test.winehq.org" )) == -1) goto done;
+    status = do_client_handshake(sock, &cred_handle, "test.winehq.org", &context);
+    closesocket(sock);
+    if (status != SEC_E_OK)
+    {
+        skip("Handshake failed\n");
+        goto done;
+    }
+
+    memset(&info, 0xcc, sizeof(info));
+    status = pQueryContextAttributesA(&context, SECPKG_ATTR_SESSION_INFO, &info);
+    ok(status == SEC_E_OK, "got %08x\n", status);
+    ok(info.dwFlags & SSL_SESSION_RECONNECT, "got flags %#x\n", info.dwFlags);
+    ok(info.cbSessionId <= sizeof(info.rgbSessionId), "got session id size %u\n", info.cbSessionId);
+    DeleteSecurityContext(&context);
+
+done:
+    FreeCredentialsHandle(&cred_handle);
+}
+
 static void init_dtls_output_buffer(SecBufferDesc *buffer)
 {
     buffer->pBuffers[0].BufferType = SECBUFFER_TOKEN;
@@ -1751,5 +1853,6 @@ START_TEST(schannel)
     test_InitializeSecurityContext();
     test_communication();
     test_application_protocol_negotiation();
+    test_session_reconnect();
     test_dtls();
 }
@@ -58,6 +58,9 @@ typedef struct regexp_t {
     struct RECharSet    *classList;    /* list of [...] bitmaps */
     const WCHAR         *source;       /* locked source string, sans // */
     DWORD               source_len;
+    const WCHAR         *prefix;       /* literal every match starts with */
+    DWORD               prefix_len;
+    WCHAR               prefix_char;   /* storage for a single character prefix */
     jsbytecode          program[1];    /* regular expression bytecode */
 } regexp_t;
 
@@ -60,6 +60,8 @@ static RTL_CRITICAL_SECTION vcomp_section = { &critsect_debug, -1, 0, 0, 0, 0 };
 #define VCOMP_DYNAMIC_FLAGS_GUIDED      0x03
 #define VCOMP_DYNAMIC_FLAGS_INCREMENT   0x40
 
+#define VCOMP_BARRIER_SPIN_COUNT        4000
+
 struct vcomp_thread_data
 {
     struct vcomp_team_data  *team;
@@ -97,8 +99,8 @@ struct vcomp_team_data
     va_list                 valist;
 
     /* barrier */
-    unsigned int            barrier;
-    int                     barrier_count;
+    LONG                    barrier;
+    LONG                    barrier_count;
 };
 
 struct vcomp_task_data
@@ -1057,25 +1059,39 @@ void CDECL _vcomp_flush(void)
 void CDECL _vcomp_barrier(void)
 {
     struct vcomp_team_data *team_data = vcomp_init_thread_data()->team;
+    LONG barrier;
+    int spin;
 
     TRACE("()\n");
 
     if (!team_data)
         return;
 
-    EnterCriticalSection(&vcomp_section);
-    if (++team_data->barrier_count >= team_data->num_threads)
+    barrier = team_data->barrier;
+    if (InterlockedIncrement(&team_data->barrier_count) >= team_data->num_threads)
     {
-        team_data->barrier++;
-        team_data->barrier_count = 0;
+        InterlockedExchange(&team_data->barrier_count, 0);
+        EnterCriticalSection(&vcomp_section);
+        InterlockedIncrement(&team_data->barrier);
         WakeAllConditionVariable(&team_data->cond);
+        LeaveCriticalSection(&vcomp_section);
+        return;
     }
-    else
+
+    /* spin for a while before going to sleep, unless the team is oversubscribed */
+    if (team_data->num_threads <= vcomp_num_procs)
     {
-        unsigned int barrier = team_data->barrier;
-        while (team_data->barrier == barrier)
-            SleepConditionVariableCS(&team_data->cond, &vcomp_section, INFINITE);
+        for (spin = 0; spin < VCOMP_BARRIER_SPIN_COUNT; spin++)
+        {
+            if (InterlockedCompareExchange(&team_data->barrier, 0, 0) != barrier)
+                return;
+            YieldProcessor();
+        }
     }
+
+    EnterCriticalSection(&vcomp_section);
+    while (team_data->barrier == barrier)
+        SleepConditionVariableCS(&team_data->cond, &vcomp_section, INFINITE);
     LeaveCriticalSection(&vcomp_section);
 }
 
@@ -22,6 +22,7 @@
 #include <assert.h>
 #include <stdarg.h>
 #include <wchar.h>
+#include <zlib.h>
 
 #define COBJMACROS
 #include "windef.h"
@@ -1866,6 +1867,15 @@ static DWORD refill_buffer( struct request *request, BOOL notify )
     return ERROR_SUCCESS;
 }
 
+/* check if we have reached the end of the data to read from the connection */
+static BOOL end_of_raw_data( struct request *request )
+{
+    if (!request->content_length) return TRUE;
+    if (request->read_chunked) return request->read_chunked_eof;
+    if (request->content_length == ~0u) return FALSE;
+    return (request->content_length == request->content_read);
+}
+
 static void finished_reading( struct request *request )
 {
     BOOL close = FALSE;
@@ -1875,6 +1885,7 @@ static void finished_reading( struct request *request )
     if (!request->netconn) return;
 
     if (request->netconn->socket == -1) close = TRUE;
+    else if (!end_of_raw_data( request )) close = TRUE;
     else if (request->hdr.disable_flags & WINHTTP_DISABLE_KEEP_ALIVE) close = TRUE;
     else if (!query_headers( request, WINHTTP_QUERY_CONNECTION, NULL, connection, &size, NULL ) ||
              !query_headers( request, WINHTTP_QUERY_PROXY_CONNECTION, NULL, connection, &size, NULL ))
@@ -1897,21 +1908,160 @@ static DWORD get_available_data( struct request *request )
     return request->read_size;
 }
 
+struct decoder
+{
+    z_stream zstream;
+    BOOL     deflate;  /* deflate content coding, may be sent with or without a zlib header */
+    BOOL     raw;      /* no zlib header was found */
+    BOOL     pending;  /* output buffer was filled, more decoded data may be available */
+    BOOL     end;      /* end of compressed stream */
+};
+
+static void *zalloc( void *opaque, unsigned int items, unsigned int size )
+{
+    return malloc( items * size );
+}
+
+static void zfree( void *opaque, void *address )
+{
+    free( address );
+}
+
+void destroy_decoder( struct request *request )
+{
+    if (!request->decoder) return;
+    inflateEnd( &request->decoder->zstream );
+    free( request->decoder );
+    request->decoder = NULL;
+}
+
+static DWORD init_decoder( struct request *request )
+{
+    WCHAR encoding[20];
+    DWORD size = sizeof(encoding);
+    struct decoder *decoder;
+    BOOL deflate;
+
+    destroy_decoder( request );
+    if (!request->decompression || !request->content_length) return ERROR_SUCCESS;
+    if (query_headers( request, WINHTTP_QUERY_CONTENT_ENCODING, NULL, encoding, &size, NULL )) return ERROR_SUCCESS;
+
+    if (!wcsicmp( encoding, L"gzip" ) && (request->decompression & WINHTTP_DECOMPRESSION_FLAG_GZIP))
+        deflate = FALSE;
+    else if (!wcsicmp( encoding, L"deflate" ) && (request->decompression & WINHTTP_DECOMPRESSION_FLAG_DEFLATE))
+        deflate = TRUE;
+    else
+    {
+        TRACE( "not decoding content encoding %s\n", debugstr_w(encoding) );
+        return ERROR_SUCCESS;
+    }
+
+    if (!(decoder = calloc( 1, sizeof(*decoder) ))) return ERROR_OUTOFMEMORY;
+    decoder->zstream.zalloc = zalloc;
+    decoder->zstream.zfree  = zfree;
+    decoder->deflate = deflate;
+
+    /* 31 accepts a gzip header only, 47 detects a zlib or gzip header */
+    if (inflateInit2( &decoder->zstream, deflate ? MAX_WBITS + 32 : MAX_WBITS + 16 ) != Z_OK)
+    {
+        free( decoder );
+        return ERROR_OUTOFMEMORY;
+    }
+    TRACE( "decoding %s content\n", debugstr_w(encoding) );
+    request->decoder = decoder;
+    return ERROR_SUCCESS;
+}
+
 /* check if we have reached the end of the data to read */
 static BOOL end_of_read_data( struct request *request )
 {
-    if (!request->content_length) return TRUE;
-    if (request->read_chunked) return request->read_chunked_eof;
-    if (request->content_length == ~0u) return FALSE;
-    return (request->content_length == request->content_read);
+    if (request->decoder)
+    {
+        if (request->decoder->end) return TRUE;
+        if (request->decoder->pending) return FALSE;
+    }
+    return end_of_raw_data( request );
 }
 
-static DWORD read_data( struct request *request, void *buffer, DWORD size, DWORD *read, BOOL async )
+/* decompress directly from the read buffer into the caller's buffer */
+static DWORD read_decoded_data( struct request *request, void *buffer, DWORD size, DWORD *read, BOOL async )
+{
+    struct decoder *decoder = request->decoder;
+    z_stream *zstream = &decoder->zstream;
+    DWORD ret = ERROR_SUCCESS;
+    int count, zret;
+    uInt avail_out;
+
+    if (!size)
+    {
+        *read = 0;
+        return ERROR_SUCCESS;
+    }
+
+    zstream->next_out  = buffer;
+    zstream->avail_out = size;
+    decoder->pending   = FALSE;
+
+    while (zstream->avail_out)
+    {
+        if (!(count = get_available_data( request )) && !end_of_raw_data( request ))
+        {
+            if ((ret = refill_buffer( request, async ))) break;
+            count = get_available_data( request );
+        }
+        zstream->next_in  = (Bytef *)request->read_buf + request->read_pos;
+        zstream->avail_in = count;
+        avail_out = zstream->avail_out;
+
+        zret = inflate( zstream, Z_SYNC_FLUSH );
+        count -= zstream->avail_in;
+
+        if (zret == Z_DATA_ERROR && decoder->deflate && !decoder->raw && !request->content_read)
+        {
+            /* some servers send deflate content without a zlib header */
+            TRACE( "retrying as raw deflate stream\n" );
+            decoder->raw = TRUE;
+            inflateReset2( zstream, -MAX_WBITS );
+            continue;
+        }
+
+        remove_data( request, count );
+        if (request->read_chunked) request->read_chunked_size -= count;
+        request->content_read += count;
+
+        if (zret == Z_STREAM_END)
+        {
+            decoder->end = TRUE;
+            break;
+        }
+        if (zret != Z_OK && zret != Z_BUF_ERROR)
+        {
+            WARN( "inflate failed %d (%s)\n", zret, debugstr_a(zstream->msg) );
+            ret = ERROR_WINHTTP_INVALID_SERVER_RESPONSE;
+            break;
+        }
+        if (!count && zstream->avail_out == avail_out)
+        {
+            if (!end_of_raw_data( request )) WARN( "no progress decoding content\n" );
+            decoder->end = TRUE;
+            break;
+        }
+    }
+    if (!ret && !decoder->end && !zstream->avail_out) decoder->pending = TRUE;
+
+    /* consume the terminating chunk so the connection can be reused */
+    if (!ret && decoder->end && request->read_chunked && !request->read_chunked_size) refill_buffer( request, async );
+
+    *read = size - zstream->avail_out;
+    return ret;
+}
+
+static DWORD read_raw_data( struct request *request, void *buffer, DWORD size, DWORD *read, BOOL async )
 {
     int count, bytes_read = 0;
     DWORD ret = ERROR_SUCCESS;
 
-    if (end_of_read_data( request )) goto done;
+    if (end_of_raw_data( request )) goto done;
 
     while (size)
     {
@@ -1927,12 +2077,26 @@ static DWORD read_data( struct request *request, void *buffer, DWORD size, DWORD
         size -= count;
         bytes_read += count;
         request->content_read += count;
-        if (end_of_read_data( request )) goto done;
+        if (end_of_raw_data( request )) goto done;
     }
     if (request->read_chunked && !request->read_chunked_size) ret = refill_buffer( request, async );
 
 done:
-    TRACE( "retrieved %u bytes (%lu/%lu)\n", bytes_read, request->content_read, request->content_length );
+    *read = bytes_read;
+    return ret;
+}
+
+static DWORD read_data( struct request *request, void *buffer, DWORD size, DWORD *read, BOOL async )
+{
+    DWORD ret = ERROR_SUCCESS, bytes_read = 0;
+
+    if (!end_of_read_data( request ))
+    {
+        if (request->decoder) ret = read_decoded_data( request, buffer, size, &bytes_read, async );
+        else ret = read_raw_data( request, buffer, size, &bytes_read, async );
+    }
+
+    TRACE( "retrieved %lu bytes (%lu/%lu)\n", bytes_read, request->content_read, request->content_length );
     if (end_of_read_data( request )) finished_reading( request );
     if (async)
     {
@@ -1956,6 +2120,7 @@ static void drain_content( struct request *request )
     DWORD size, bytes_read, bytes_total = 0, bytes_left = request->content_length - request->content_read;
     char buffer[2048];
 
+    destroy_decoder( request );
     refill_buffer( request, FALSE );
     for (;;)
     {
@@ -2203,6 +2368,13 @@ static DWORD send_request( struct request *request, const WCHAR *headers, DWORD
     {
         process_header( request, L"Connection", L"Keep-Alive", WINHTTP_ADDREQ_FLAG_ADD_IF_NEW, TRUE );
     }
+    if (request->decompression)
+    {
+        const WCHAR *encoding = L"gzip, deflate";
+        if (!(request->decompression & WINHTTP_DECOMPRESSION_FLAG_DEFLATE)) encoding = L"gzip";
+        else if (!(request->decompression & WINHTTP_DECOMPRESSION_FLAG_GZIP)) encoding = L"deflate";
+        process_header( request, L"Accept-Encoding", encoding, WINHTTP_ADDREQ_FLAG_ADD_IF_NEW, TRUE );
+    }
     if (request->hdr.flags & WINHTTP_FLAG_REFRESH)
     {
         process_header( request, L"Pragma", L"no-cache", WINHTTP_ADDREQ_FLAG_ADD_IF_NEW, TRUE );
@@ -2829,7 +3001,8 @@ static DWORD receive_response( struct request *request, BOOL async )
     }
 
     if (request->netconn) netconn_set_timeout( request->netconn, FALSE, request->receive_timeout );
-    if (request->content_length) ret = refill_buffer( request, FALSE );
+    if (!ret) ret = init_decoder( request );
+    if (request->content_length && !ret) ret = refill_buffer( request, FALSE );
 
     if (async)
     {
@@ -2900,6 +3073,7 @@ static DWORD query_data_ready( struct request *request )
 
     count = get_available_data( request );
     if (!request->read_chunked && request->netconn) count += netconn_query_data_available( request->netconn );
+    if (!count && request->decoder && request->decoder->pending) count = 1;
 
     return count;
 }
@@ -210,6 +210,16 @@ static BOOL session_set_option( struct object_header *hdr, DWORD option, void *b
         SetLastError( ERROR_WINHTTP_INCORRECT_HANDLE_TYPE );
         return FALSE;
 
+    case WINHTTP_OPTION_DECOMPRESSION:
+        if (buflen != sizeof(DWORD))
+        {
+            SetLastError( ERROR_INSUFFICIENT_BUFFER );
+            return FALSE;
+        }
+        session->decompression = *(DWORD *)buffer & WINHTTP_DECOMPRESSION_FLAG_ALL;
+        TRACE( "WINHTTP_OPTION_DECOMPRESSION %#lx\n", session->decompression );
+        return TRUE;
+
     case WINHTTP_OPTION_RESOLVE_TIMEOUT:
         session->resolve_timeout = *(DWORD *)buffer;
         return TRUE;
@@ -655,6 +665,7 @@ static void request_destroy( struct object_header *hdr )
     CertFreeCertificateContext( request->server_cert );
     CertFreeCertificateContext( request->client_cert );
 
+    destroy_decoder( request );
     destroy_authinfo( request->authinfo );
     destroy_authinfo( request->proxy_authinfo );
 
@@ -1131,6 +1142,16 @@ static BOOL request_set_option( struct object_header *hdr, DWORD option, void *b
         FIXME("WINHTTP_OPTION_MAX_RESPONSE_DRAIN_SIZE\n");
         return TRUE;
 
+    case WINHTTP_OPTION_DECOMPRESSION:
+        if (buflen != sizeof(DWORD))
+        {
+            SetLastError( ERROR_INSUFFICIENT_BUFFER );
+            return FALSE;
+        }
+        request->decompression = *(DWORD *)buffer & WINHTTP_DECOMPRESSION_FLAG_ALL;
+        TRACE( "WINHTTP_OPTION_DECOMPRESSION %#lx\n", request->decompression );
+        return TRUE;
+
     case WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL:
         if (buflen == sizeof(DWORD))
         {
@@ -1271,6 +1292,7 @@ HINTERNET WINAPI WinHttpOpenRequest( HINTERNET hconnect, const WCHAR *verb, cons
     request->websocket_receive_buffer_size = connect->session->websocket_receive_buffer_size;
     request->websocket_send_buffer_size = connect->session->websocket_send_buffer_size;
     request->websocket_set_send_buffer_size = request->websocket_send_buffer_size;
+    request->decompression = connect->session->decompression;
 
     if (!verb || !verb[0]) verb = L"GET";
     if (!(request->verb = strdupW( verb ))) goto end;
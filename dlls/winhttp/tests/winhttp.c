@@ -2281,6 +2281,15 @@ static const char redirectmsg[] =
 "Location: /temporary\r\n"
 "Connection: close\r\n\r\n";
 
+static const char gzipmsg[] =
+"HTTP/1.1 200 OK\r\n"
+"Server: winetest\r\n"
+"Content-Encoding: gzip\r\n"
+"Content-Length: 38\r\n"
+"\r\n"
+"\x1f\x8b\x08\x00\x00\x00\x00\x00\x02\x03\x4b\xce\xcf\x2d\x28\x4a\x2d\x2e\x4e\x4d\x51\x48\xce"
+"\xcf\x2b\x49\xcd\x2b\x01\x00\x98\x40\x31\x69\x12\x00\x00\x00";
+
 static const char unauthorized[] = "Unauthorized";
 static const char hello_world[] = "Hello World";
 static const char auth_unseen[] = "Auth Unseen";
@@ -2413,6 +2422,12 @@ static DWORD CALLBACK server_thread(LPVOID param)
             else send(c, notokmsg, sizeof(notokmsg) - 1, 0);
             continue;
         }
+        if (strstr(buffer, "GET /gzip"))
+        {
+            ok(!!strstr(buffer, "Accept-Encoding: gzip, deflate\r\n"), "got %s\n", debugstr_a(buffer));
+            send(c, gzipmsg, sizeof gzipmsg - 1, 0);
+            continue;
+        }
         if (strstr(buffer, "HEAD /head"))
         {
             send(c, headmsg, sizeof headmsg - 1, 0);
@@ -3747,6 +3762,54 @@ static void test_not_modified(int port)
     ok(start <= 2000, "Expected less than 2 seconds for the test, got %lu ms\n", start);
 }
 
+static void test_decompression(int port)
+{
+    HINTERNET ses, con, req;
+    DWORD flags, size;
+    char buffer[64];
+    BOOL ret;
+
+    ses = WinHttpOpen(L"winetest", WINHTTP_ACCESS_TYPE_NO_PROXY, NULL, NULL, 0);
+    ok(ses != NULL, "failed to open session %lu\n", GetLastError());
+
+    flags = WINHTTP_DECOMPRESSION_FLAG_ALL;
+    SetLastError(0xdeadbeef);
+    ret = WinHttpSetOption(ses, WINHTTP_OPTION_DECOMPRESSION, &flags, sizeof(flags) - 1);
+    ok(!ret, "expected failure\n");
+    ok(GetLastError() == ERROR_INSUFFICIENT_BUFFER, "got %lu\n", GetLastError());
+
+    ret = WinHttpSetOption(ses, WINHTTP_OPTION_DECOMPRESSION, &flags, sizeof(flags));
+    ok(ret, "failed to set decompression option %lu\n", GetLastError());
+
+    con = WinHttpConnect(ses, L"localhost", port, 0);
+    ok(con != NULL, "failed to open a connection %lu\n", GetLastError());
+
+    req = WinHttpOpenRequest(con, NULL, L"/gzip", NULL, NULL, NULL, 0);
+    ok(req != NULL, "failed to open a request %lu\n", GetLastError());
+
+    ret = WinHttpSendRequest(req, NULL, 0, NULL, 0, 0, 0);
+    ok(ret, "failed to send request %lu\n", GetLastError());
+
+    ret = WinHttpReceiveResponse(req, NULL);
+    ok(ret, "failed to receive response %lu\n", GetLastError());
+
+    size = 0;
+    memset(buffer, 0, sizeof(buffer));
+    ret = WinHttpReadData(req, buffer, sizeof(buffer), &size);
+    ok(ret, "failed to read data %lu\n", GetLastError());
+    ok(size == sizeof("compressed content") - 1, "got %lu\n", size);
+    ok(!strcmp(buffer, "compressed content"), "got %s\n", debugstr_a(buffer));
+
+    size = 0xdeadbeef;
+    ret = WinHttpReadData(req, buffer, sizeof(buffer), &size);
+    ok(ret, "failed to read data %lu\n", GetLastError());
+    ok(!size, "got %lu\n", size);
+
+    WinHttpCloseHandle(req);
+    WinHttpCloseHandle(con);
+    WinHttpCloseHandle(ses);
+}
+
 static void test_bad_header( int port )
 {
     WCHAR buffer[32];
@@ -5818,6 +5881,7 @@ START_TEST (winhttp)
     test_large_data_authentication(si.port);
     test_bad_header(si.port);
     test_multiple_reads(si.port);
+    test_decompression(si.port);
     test_cookies(si.port);
     test_request_path_escapes(si.port);
     test_passport_auth(si.port);
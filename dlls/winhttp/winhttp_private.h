@@ -85,6 +85,7 @@ struct session
     HANDLE unload_event;
     DWORD secure_protocols;
     DWORD passport_flags;
+    DWORD decompression;
     unsigned int websocket_receive_buffer_size;
     unsigned int websocket_send_buffer_size;
 };
@@ -219,6 +220,8 @@ struct request
     } creds[TARGET_MAX][SCHEME_MAX];
     unsigned int websocket_receive_buffer_size;
     unsigned int websocket_send_buffer_size, websocket_set_send_buffer_size;
+    DWORD decompression;     /* WINHTTP_DECOMPRESSION_FLAG_* */
+    struct decoder *decoder; /* decodes the response body if it has a supported content coding */
 };
 
 enum socket_state
@@ -391,6 +394,7 @@ DWORD add_request_headers( struct request *, const WCHAR *, DWORD, DWORD ) DECLS
 void destroy_cookies( struct session * ) DECLSPEC_HIDDEN;
 BOOL set_server_for_hostname( struct connect *, const WCHAR *, INTERNET_PORT ) DECLSPEC_HIDDEN;
 void destroy_authinfo( struct authinfo * ) DECLSPEC_HIDDEN;
+void destroy_decoder( struct request * ) DECLSPEC_HIDDEN;
 
 void release_host( struct hostdata * ) DECLSPEC_HIDDEN;
 DWORD process_header( struct request *, const WCHAR *, const WCHAR *, DWORD, BOOL ) DECLSPEC_HIDDEN;
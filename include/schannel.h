@@ -173,6 +173,7 @@ static const WCHAR SCHANNEL_NAME_W[] = { 'S','c','h','a','n','n','e','l',0 };
 #define SCH_CRED_NO_DEFAULT_CREDS                    16
 #define SCH_CRED_AUTO_CRED_VALIDATION                32
 #define SCH_CRED_USE_DEFAULT_CREDS                   64
+#define SCH_CRED_DISABLE_RECONNECTS                  128
 #define SCH_CRED_REVOCATION_CHECK_CHAIN_END_CERT     256
 #define SCH_CRED_REVOCATION_CHECK_CHAIN              512
 #define SCH_CRED_REVOCATION_CHECK_CHAIN_EXCLUDE_ROOT 1024
@@ -299,4 +300,13 @@ typedef struct _SecPkgContext_ConnectionInfo
     DWORD dwExchStrength;
 } SecPkgContext_ConnectionInfo, *PSecPkgContext_ConnectionInfo;
 
+#define SSL_SESSION_RECONNECT 1
+
+typedef struct _SecPkgContext_SessionInfo
+{
+    DWORD dwFlags;
+    DWORD cbSessionId;
+    BYTE rgbSessionId[32];
+} SecPkgContext_SessionInfo, *PSecPkgContext_SessionInfo;
+
 #endif /* __WINE_SCHANNEL_H__ */
@@ -104,6 +104,7 @@ struct thread_input
     int                    caret_hide;    /* caret hide count */
     int                    caret_state;   /* caret on/off state */
     struct list            msg_list;      /* list of hardware messages */
+    unsigned int           rawinput_count; /* number of WM_INPUT messages in msg_list */
     unsigned char          desktop_keystate[256]; /* desktop keystate when keystate was synced */
     struct object         *shared_mapping; /* thread input shared memory mapping */
     volatile struct input_shared_memory *shared;  /* thread input shared memory ptr */
@@ -317,6 +318,7 @@ static struct thread_input *create_thread_input( struct thread *thread )
         memset( (void *)input->shared->keystate, 0, sizeof(input->shared->keystate) );
         SHARED_WRITE_END( &input->shared->seq );
         list_init( &input->msg_list );
+        input->rawinput_count = 0;
         set_caret_window( input, 0 );
 
         if (!(input->desktop = get_thread_desktop( thread, 0 /* FIXME: access rights */ )))
@@ -694,6 +696,14 @@ static inline unsigned int get_unique_id(void)
     return id;
 }
 
+/* remove a hardware message from its thread input list and free it */
+static void remove_hardware_message( struct thread_input *input, struct message *msg )
+{
+    if (msg->msg == WM_INPUT) input->rawinput_count--;
+    list_remove( &msg->entry );
+    free_message( msg );
+}
+
 static int merge_pointer_update_message( struct thread_input *input, const struct message *msg )
 {
     struct hardware_msg_data *prev_data, *msg_data = msg->data;
@@ -1677,8 +1687,7 @@ static void release_hardware_message( struct msg_queue *queue, unsigned int hw_i
     if (clr_bit) clear_queue_bits( queue, clr_bit );
 
     update_input_key_state( input, msg->msg, msg->wparam );
-    list_remove( &msg->entry );
-    free_message( msg );
+    remove_hardware_message( input, msg );
 }
 
 static int queue_hotkey_message( struct desktop *desktop, struct message *msg )
@@ -1868,6 +1877,7 @@ static void queue_hardware_message( struct desktop *desktop, struct message *msg
     {
         msg->unique_id = 0;  /* will be set once we return it to the app */
         list_add_tail( &input->msg_list, &msg->entry );
+        if (msg->msg == WM_INPUT) input->rawinput_count++;
         set_queue_bits( thread->queue, get_hardware_msg_bit(msg) );
     }
     release_object( thread );
@@ -2474,8 +2484,7 @@ static int get_hardware_message( struct thread *thread, unsigned int hw_id, user
         {
             /* no window at all, remove it */
             update_input_key_state( input, msg->msg, msg->wparam );
-            list_remove( &msg->entry );
-            free_message( msg );
+            remove_hardware_message( input, msg );
             continue;
         }
         if (win_thread != thread)
@@ -2490,8 +2499,7 @@ static int get_hardware_message( struct thread *thread, unsigned int hw_id, user
             {
                 /* for another thread input, drop it */
                 update_input_key_state( input, msg->msg, msg->wparam );
-                list_remove( &msg->entry );
-                free_message( msg );
+                remove_hardware_message( input, msg );
             }
             release_object( win_thread );
             continue;
@@ -3752,16 +3760,32 @@ DECL_HANDLER(get_rawinput_buffer)
 {
     struct thread_input *input = current->queue->input;
     data_size_t size = 0, next_size = 0;
+    unsigned int remaining = input->rawinput_count;
     struct list *ptr;
     char *buf, *cur, *tmp;
-    int count = 0, buf_size = 16 * sizeof(struct hardware_msg_data);
+    int count = 0, buf_size;
+
+    if (!remaining)
+    {
+        reply->next_size = 0;
+        reply->count = 0;
+        return;
+    }
+
+    /* size the buffer for every queued message so that high-rate devices don't cause
+     * repeated reallocations; HID reports may still need to grow it */
+    buf_size = remaining * sizeof(struct hardware_msg_data);
+    if (req->rawinput_size && req->buffer_size / req->rawinput_size < remaining)
+        buf_size = (req->buffer_size / req->rawinput_size + 1) * sizeof(struct hardware_msg_data);
+    if (buf_size > get_reply_max_size()) buf_size = get_reply_max_size();
+    if (buf_size < 16 * sizeof(struct hardware_msg_data)) buf_size = 16 * sizeof(struct hardware_msg_data);
 
     if (!req->buffer_size) buf = NULL;
     else if (!(buf = mem_alloc( buf_size ))) return;
 
     cur = buf;
     ptr = list_head( &input->msg_list );
-    while (ptr)
+    while (ptr && remaining)
     {
         struct message *msg = LIST_ENTRY( ptr, struct message, entry );
         struct hardware_msg_data *data = msg->data;
@@ -3778,6 +3802,7 @@ DECL_HANDLER(get_rawinput_buffer)
             buf_size += buf_size / 2 + extra_size;
             if (!(tmp = realloc( buf, buf_size )))
             {
+                free( buf );
                 set_error( STATUS_NO_MEMORY );
                 return;
             }
@@ -3786,8 +3811,8 @@ DECL_HANDLER(get_rawinput_buffer)
         }
 
         memcpy( cur, data, data->size );
-        list_remove( &msg->entry );
-        free_message( msg );
+        remove_hardware_message( input, msg );
+        remaining--;
 
         size += next_size;
         cur += sizeof(*data);
@@ -73,6 +73,9 @@ struct window
     rectangle_t      client_rect;     /* client rectangle (relative to parent client area) */
     struct region   *win_region;      /* region for shaped windows (relative to window rect) */
     struct region   *update_region;   /* update region (relative to window rect) */
+    struct region   *vis_rgn_cache;   /* cached visible region (relative to window) */
+    unsigned int     vis_rgn_flags;   /* DCX flags the cached visible region was computed for */
+    unsigned int     vis_rgn_generation; /* visible region generation of the cached region */
     unsigned int     style;           /* window style */
     unsigned int     ex_style;        /* window extended style */
     unsigned int     id;              /* window id */
@@ -107,6 +110,15 @@ struct window
 #define PAINT_DELAYED_ERASE      0x0080  /* still needs erase after WM_ERASEBKGND */
 #define PAINT_PIXEL_FORMAT_CHILD 0x0100  /* at least one child has a custom pixel format */
 
+/* generation counter of the window visible regions, incremented whenever a change
+ * of window geometry, Z-order, visibility or shape may affect them */
+static unsigned int visible_region_generation = 1;
+
+static inline void invalidate_visible_regions(void)
+{
+    visible_region_generation++;
+}
+
 /* growable array of user handles */
 struct user_handle_array
 {
@@ -240,6 +252,7 @@ static void link_window( struct window *win, struct window *previous )
     }
 
     win->is_linked = 1;
+    invalidate_visible_regions();
 }
 
 /* change the parent of a window (or unlink the window if the new parent is NULL) */
@@ -281,6 +294,7 @@ static int set_parent_window( struct window *win, struct window *parent )
         list_remove( &win->entry );  /* unlink it from the previous location */
         list_add_head( &win->parent->unlinked, &win->entry );
         win->is_linked = 0;
+        invalidate_visible_regions();
     }
     return 1;
 }
@@ -494,6 +508,7 @@ static struct window *create_window( struct window *parent, struct window *owner
     win->atom           = atom;
     win->last_active    = win->handle;
     win->win_region     = NULL;
+    win->vis_rgn_cache  = NULL;
     win->update_region  = NULL;
     win->style          = 0;
     win->ex_style       = 0;
@@ -1017,7 +1032,7 @@ static inline struct window *get_top_clipping_window( struct window *win )
 
 
 /* compute the visible region of a window, in window coordinates */
-static struct region *get_visible_region( struct window *win, unsigned int flags )
+static struct region *compute_visible_region( struct window *win, unsigned int flags )
 {
     struct region *tmp = NULL, *region;
     int offset_x, offset_y;
@@ -1096,6 +1111,39 @@ error:
 }
 
 
+/* get the visible region of a window, in window coordinates, using the cached region if still valid */
+static struct region *get_visible_region( struct window *win, unsigned int flags )
+{
+    struct region *region;
+
+    flags &= DCX_PARENTCLIP | DCX_WINDOW | DCX_CLIPCHILDREN;
+
+    if (win->vis_rgn_cache && win->vis_rgn_generation == visible_region_generation &&
+        win->vis_rgn_flags == flags)
+    {
+        if (!(region = create_empty_region())) return NULL;
+        if (copy_region( region, win->vis_rgn_cache )) return region;
+        free_region( region );
+        return NULL;
+    }
+
+    if (!(region = compute_visible_region( win, flags ))) return NULL;
+
+    if (!win->vis_rgn_cache) win->vis_rgn_cache = create_empty_region();
+    if (win->vis_rgn_cache && copy_region( win->vis_rgn_cache, region ))
+    {
+        win->vis_rgn_flags = flags;
+        win->vis_rgn_generation = visible_region_generation;
+    }
+    else if (win->vis_rgn_cache)
+    {
+        free_region( win->vis_rgn_cache );
+        win->vis_rgn_cache = NULL;
+    }
+    return region;
+}
+
+
 /* clip all children with a custom pixel format out of the visible region */
 static struct region *clip_pixel_format_children( struct window *parent, struct region *parent_clip,
                                                   struct region *region, int offset_x, int offset_y )
@@ -1719,6 +1767,8 @@ static void set_window_pos( struct window *win, struct window *previous,
         }
     }
 
+    invalidate_visible_regions();
+
     /* reset cursor clip rectangle when the desktop changes size */
     if (win == win->desktop->top_window) set_clip_rectangle( win->desktop, NULL, 0 );
 
@@ -1857,6 +1907,7 @@ static void set_window_region( struct window *win, struct region *region, int re
 
     if (win->win_region) free_region( win->win_region );
     win->win_region = region;
+    invalidate_visible_regions();
 
     /* expose anything revealed by the change */
     if (old_vis_rgn && ((exposed_rgn = expose_window( win, &win->window_rect, old_vis_rgn ))))
@@ -1878,6 +1929,7 @@ void destroy_window( struct window *win )
     {
         struct region *vis_rgn = get_visible_region( win, DCX_WINDOW );
         win->style &= ~WS_VISIBLE;
+        invalidate_visible_regions();
         if (vis_rgn)
         {
             struct region *exposed_rgn = expose_window( win, &win->window_rect, vis_rgn );
@@ -1905,6 +1957,7 @@ void destroy_window( struct window *win )
     free_user_handle( win->handle );
     destroy_properties( win );
     list_remove( &win->entry );
+    invalidate_visible_regions();
     if (is_desktop_window(win))
     {
         struct desktop *desktop = win->desktop;
@@ -1920,6 +1973,7 @@ void destroy_window( struct window *win )
     detach_window_thread( win );
     if (win->win_region) free_region( win->win_region );
     if (win->update_region) free_region( win->update_region );
+    if (win->vis_rgn_cache) free_region( win->vis_rgn_cache );
     if (win->class) release_class( win->class );
     free( win->text );
     memset( win, 0x55, sizeof(*win) + win->nb_extra_bytes - 1 );
@@ -2142,6 +2196,7 @@ DECL_HANDLER(set_window_info)
         else win->ex_style = (req->ex_style & ~WS_EX_TOPMOST) | (win->ex_style & WS_EX_TOPMOST);
         if (!(win->ex_style & WS_EX_LAYERED)) win->is_layered = 0;
     }
+    if (req->flags & (SET_WIN_STYLE | SET_WIN_EXSTYLE)) invalidate_visible_regions();
     if (req->flags & SET_WIN_ID) win->id = req->id;
     if (req->flags & SET_WIN_INSTANCE) win->instance = req->instance;
     if (req->flags & SET_WIN_UNICODE) win->is_unicode = req->is_unicode;
@@ -2673,6 +2728,7 @@ DECL_HANDLER(update_window_zorder)
         {
             list_remove( &win->entry );
             list_add_before( &ptr->entry, &win->entry );
+            invalidate_visible_regions();
         }
         break;
     }